@@ -21,10 +21,61 @@
 #endif
 #include <getopt.h>
 #include <cstdlib>
+#include <cstdio>
 #include <queue>
+#include <vector>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "TFileMerger.h"
 
 
 
+// Digitizes the events of the entries [first, end) of the hit file and writes the singles
+void DigitizeEntries(GateCCHitFileReader* hitFileReader, GateDigitizer* digitizer, const G4String& chainName,
+                     G4long first, G4long end, const std::string& singlesFileName)
+{
+    //Prepare output file
+    TFile* pTfile = new TFile(singlesFileName.c_str(),"RECREATE");
+    //Prepare Tree
+    GateCCSingleTree* m_SingleTree=new GateCCSingleTree("Singles");
+    GateCCRootSingleBuffer  m_SinglesBuffer;
+    m_SingleTree->Init(m_SinglesBuffer);
+
+    //Read Hits tree
+    hitFileReader->SelectEntries(first, end);
+    while(hitFileReader->HasNextEvent()){
+
+        hitFileReader->PrepareNextEvent();
+        digitizer->Digitize(hitFileReader->PrepareEndOfEvent());
+        //SaveInto Single tree the pulses
+        GatePulseList* pPulseList=digitizer->FindPulseList(chainName);
+        if(pPulseList){
+            if(pPulseList->size()>0){
+
+
+               GatePulseConstIterator iterIn;
+                for (iterIn = pPulseList->begin() ; iterIn != pPulseList->end() ; ++iterIn){
+
+                    GateDigi* aSingleDigi=new GateDigi(*iterIn);
+
+
+                    m_SinglesBuffer.Fill(aSingleDigi);
+                    m_SingleTree->Fill();
+                    m_SinglesBuffer.Clear();
+
+	             if(aSingleDigi){
+                        delete aSingleDigi;
+                        aSingleDigi=0;
+                    }
+                }
+            }
+        }
+
+    }
+    pTfile->Write();
+    delete pTfile;
+}
+
 
 
 int main(int argc, char *argv[])
@@ -35,11 +86,13 @@ int main(int argc, char *argv[])
           << "Gate_CC_hits_digitizer" << std::endl
           << "Gate for Compton Camera" << std::endl
           << "Process hits to provide singles" << std::endl
-          << "Usage : " << argv[0] << " <hit.root> <singles.root> <options.mac>" << std::endl;
+          << "Usage : " << argv[0] << " <hit.root> <singles.root> <options.mac> [number of processes]" << std::endl
+          << "With several processes, each one digitizes a range of events of the hit file," << std::endl
+          << "the singles are then merged in the order of the events" << std::endl;
 
     // Get user parameters
-    if (argc != 4) {
-        std::cout << "Need 4 parameters" << std::endl
+    if (argc != 4 && argc != 5) {
+        std::cout << "Need 4 or 5 parameters" << std::endl
                   << usage.str() << std::endl;
         exit(0);
     }
@@ -48,6 +101,11 @@ int main(int argc, char *argv[])
     std::string hits_filePathName=argv[1];
     std::string singles_filePathName = argv[2];
     std::string options_macrofile = argv[3];
+    int nbOfProcesses = (argc == 5) ? atoi(argv[4]) : 1;
+    if (nbOfProcesses < 1) {
+        std::cout << "The number of processes should be at least 1" << std::endl;
+        exit(0);
+    }
 
     size_t foundPoint =  options_macrofile.find_last_of( "." );
     // Finding suffix
@@ -97,49 +155,67 @@ int main(int argc, char *argv[])
 
 
 
-    //Prepare output file
-    TFile* pTfile = new TFile(singles_filePathName.c_str(),"RECREATE");
-    //Prepare Tree
-    GateCCSingleTree* m_SingleTree=new GateCCSingleTree("Singles");
-    GateCCRootSingleBuffer  m_SinglesBuffer;
-    m_SingleTree->Init(m_SinglesBuffer);
-
-
-
-    //Read Hits tree
     GateCCHitFileReader* m_hitFileReader= GateCCHitFileReader::GetInstance(hits_filePathName);
     m_hitFileReader->PrepareAcquisition();
-    while(m_hitFileReader->HasNextEvent()){
-
-        m_hitFileReader->PrepareNextEvent();
-        digitizer->Digitize(m_hitFileReader->PrepareEndOfEvent());
-        //SaveInto Single tree the pulses
-        GatePulseList* pPulseList=digitizer->FindPulseList(thechainName);
-        if(pPulseList){
-            if(pPulseList->size()>0){
-
-
-               GatePulseConstIterator iterIn;
-                for (iterIn = pPulseList->begin() ; iterIn != pPulseList->end() ; ++iterIn){
 
-                    GateDigi* aSingleDigi=new GateDigi(*iterIn);
-
-
-                    m_SinglesBuffer.Fill(aSingleDigi);
-                    m_SingleTree->Fill();
-                    m_SinglesBuffer.Clear();
-
-	             if(aSingleDigi){
-                        delete aSingleDigi;
-                        aSingleDigi=0;
-                    }
-                }
+    if (nbOfProcesses == 1) {
+        DigitizeEntries(m_hitFileReader, digitizer, thechainName, 0, m_hitFileReader->GetNumberOfEntries(), singles_filePathName);
+        m_hitFileReader->TerminateAfterAcquisition();
+    }
+    else {
+        // Ranges of about the same number of hits, starting on event boundaries
+        const G4long nbOfEntries = m_hitFileReader->GetNumberOfEntries();
+        std::vector<G4long> rangeStart(nbOfProcesses+1, nbOfEntries);
+        for (int p=0; p<nbOfProcesses; p++)
+            rangeStart[p] = m_hitFileReader->FindEventStart(nbOfEntries*p/nbOfProcesses);
+        // Each process reads the hit file with its own file descriptor
+        m_hitFileReader->TerminateAfterAcquisition();
+
+        std::vector<std::string> partFileNames;
+        std::vector<pid_t> pids;
+        std::cout << std::flush;
+        for (int p=0; p<nbOfProcesses; p++) {
+            partFileNames.push_back(singles_filePathName + ".part" + std::to_string(p) + ".root");
+            pid_t pid = fork();
+            if (pid < 0) {
+                std::cerr << "Cannot fork process " << p << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            if (pid == 0) {
+                randomEngine->InitializeForProcess(p, nbOfProcesses);
+                m_hitFileReader->PrepareAcquisition();
+                DigitizeEntries(m_hitFileReader, digitizer, thechainName, rangeStart[p], rangeStart[p+1], partFileNames[p]);
+                m_hitFileReader->TerminateAfterAcquisition();
+                std::cout << std::flush;
+                fflush(NULL);
+                _exit(EXIT_SUCCESS);
             }
+            pids.push_back(pid);
         }
 
+        bool failed = false;
+        for (int p=0; p<nbOfProcesses; p++) {
+            int status = 0;
+            waitpid(pids[p], &status, 0);
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                std::cerr << "Process " << p << " failed" << std::endl;
+                failed = true;
+            }
+        }
+        if (failed) exit(EXIT_FAILURE);
+
+        // The parts are merged in process order: the singles stay in the order of the events
+        TFileMerger merger(kFALSE);
+        merger.OutputFile(singles_filePathName.c_str(), "RECREATE");
+        for (int p=0; p<nbOfProcesses; p++)
+            merger.AddFile(partFileNames[p].c_str(), kFALSE);
+        if (!merger.Merge()) {
+            std::cerr << "Cannot merge the singles into " << singles_filePathName << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        for (int p=0; p<nbOfProcesses; p++)
+            std::remove(partFileNames[p].c_str());
     }
-    pTfile->Write();
-    m_hitFileReader->TerminateAfterAcquisition();
 
     delete  randomEngine;
     delete runManager;
@@ -62,6 +62,7 @@ public:
   void AddActor(G4String actorType, G4String actorName, int depth=0);
   void CreateListsOfEnabledActors();
   void PrintListOfActors() const;
+  void PrintMemoryReport() const;
   void PrintListOfActorTypes() const;
   GateVActor*  GetActor(const G4String &actorType, const G4String &actorName);
 
@@ -26,6 +26,7 @@ See LICENSE.md for further details
 #include "GateCrystalSD.hh"
 
 #include "globals.hh"
+#include <unordered_map>
 
 #include "GateAdderMessenger.hh"
 #include "GateSinglesDigitizer.hh"
@@ -42,6 +43,9 @@ public:
 
   void Digitize() override;
 
+  G4bool IsInPlaceCapable() const override { return true; }
+  void DigitizeInPlace(std::vector<GateDigi*>& digis) override;
+
 
   void SetPositionPolicy(const G4String& policy);
  
@@ -58,6 +62,9 @@ private:
   GateDigiCollection*  m_OutputDigiCollection;
   GateSinglesDigitizer *m_digitizer;
 
+  //! Position of the output digi of each volume in the output collection, keyed by volumeID handle
+  std::unordered_map<G4int, size_t> m_outputDigiIndex;
+
 
 
 
@@ -76,6 +76,19 @@ public:
 
     void TerminateAfterAcquisition();
 
+    //! Returns the number of entries (hits) of the hit tree (the file must be open)
+    G4long GetNumberOfEntries() const          { return (G4long)m_entries; }
+    //! Returns the first entry of the event that is in progress at 'entry', or the first entry of the
+    //! next event if 'entry' starts one. Only the eventID and runID branches are read.
+    //! The hit buffer is changed: SelectEntries() must be called before reading events.
+    G4long FindEventStart(G4long entry);
+    //! Restricts the reading to the entries [first, end), which should start and end on event boundaries
+    //! (see FindEventStart()), and loads the first hit of the range
+    void SelectEntries(G4long first, G4long end);
+
+    //! Size of the ROOT cache (in bytes): the branches are read by baskets of many hits
+    void SetCacheSize(G4long size)             { m_cacheSize = size; }
+
     //! Get the hit file name
     const  G4String& GetFileName()             { return m_fileName; };
     //! Set the hit file name
@@ -101,7 +114,8 @@ protected:
 
     TTree*              m_hitTree;       	      //!< the input hit tree
     Stat_t       	      m_entries;      	      //!< Number of entries in the tree
-    G4int       	      m_currentEntry; 	      //!< Current entry in the tree
+    G4long       	      m_currentEntry; 	      //!< Current entry in the tree
+    G4long              m_cacheSize;          //!< Size of the ROOT cache of the tree
 
 
     GateCCRootHitBuffer        m_hitBuffer;       	      //!< Buffer to store the data read from the hit-tree
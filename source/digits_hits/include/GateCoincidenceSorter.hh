@@ -12,7 +12,7 @@ See LICENSE.md for further details
 
 #include "globals.hh"
 #include <iostream>
-#include <list>
+#include <vector>
 #include <deque>
 #include "G4ThreeVector.hh"
 
@@ -24,6 +24,7 @@ See LICENSE.md for further details
 class GateCoincidenceSorterMessenger;
 class GateVSystem;
 class GateDigitizerMgr;
+class GateSinglesDigitizer;
 
 /*! \class  GateCoincidenceSorter
     \brief  Coincidence sorter for a  PET scanner
@@ -135,7 +136,7 @@ public:
     const G4String& GetInputName() const
     { return m_inputName; }
     void SetInputName(const G4String& anInputName)
-    {   m_inputName = anInputName;}
+    {   m_inputName = anInputName; m_inputDigitizer = 0;}
 
     const G4String& GetOutputName() const
     { return m_outputName; }
@@ -166,6 +167,10 @@ public:
     void SetSystem(G4String& inputName); //This method was added for the multi-system approach
 
     void SetMultiplesPolicy(const G4String& policy);
+
+    //! Shares the presort buffer of another sorter reading the same singles: the leader
+    //! sorts the digis once and feeds them to the windows of all its followers
+    void SetSortingLeader(GateCoincidenceSorter* leader);
     //TODO GND 2022 CC
     void SetAcceptancePolicy4CC(const G4String& policy);
 
@@ -201,9 +206,25 @@ private:
     //@{
     G4bool m_forceMinSecDifferenceToZero;
  
-    std::list<GateDigi*> m_presortBuffer;      // incoming digis are presorted and buffered
+    //! Entry of the presort buffer, digis with the same time leave the buffer in arrival order
+    struct PresortEntry
+    {
+      G4double  time;
+      G4long    order;
+      GateDigi* digi;
+      //! Reversed order: the standard heap algorithms keep the largest element on top
+      bool operator<(const PresortEntry& other) const
+      { return time > other.time || (time == other.time && order > other.order); }
+    };
+
+    std::vector<PresortEntry> m_presortBuffer;  // incoming digis are presorted and buffered (min-heap on time)
     G4int                 m_presortBufferSize;
+    G4long                m_presortCounter;     // arrival order of the buffered digis
     G4bool                m_presortWarning;     // avoid repeat warnings
+
+    //! Returns the digitizer producing the input singles, looked up once
+    GateSinglesDigitizer* GetInputDigitizer();
+    GateSinglesDigitizer* m_inputDigitizer;
   
     bool                m_CCSorter;     // compton camera sorter
     G4bool             m_triggerOnlyByAbsorber; //! Is the window only open by digis generated in the absorber ?
@@ -213,6 +234,12 @@ private:
 
     std::deque<GateCoincidenceDigi*> m_coincidenceDigis;  // open coincidence windows
 
+    GateCoincidenceSorter*              m_sortingLeader;    // sorter doing the presort for this one, 0 if none
+    std::vector<GateCoincidenceSorter*> m_sortingFollowers; // sorters using the presort of this one
+
+    //! Adds a digi leaving the presort buffer to the coincidence windows (the digi is copied if not owned)
+    void ProcessSortedDigi(GateDigi* digi, G4bool ownsDigi);
+
     void ProcessCompletedCoincidenceWindow(GateCoincidenceDigi*);
     //TODO GND 2022 CC
     void ProcessCompletedCoincidenceWindow4CC(GateCoincidenceDigi *);
@@ -69,6 +69,7 @@ private:
     G4UIcmdWithABool            *AllDigiOpenCoincGateCmd;  //!< The UI command "allowMultiples"
     G4UIcmdWithABool            *SetTriggerOnlyByAbsorberCmd;
     G4UIcmdWithABool            *SetEventIDCoincCmd;
+    G4UIcmdWithAString          *ShareSortingWithCmd;  //!< The UI command "shareSortingWith"
     GateCoincidenceSorter* m_CoincidenceSorter;
 
 };
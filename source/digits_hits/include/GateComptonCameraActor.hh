@@ -27,10 +27,12 @@
 #include "GateTreeFileManager.hh"
 
 #include  <iomanip>
+#include  <map>
 
 
 class G4EmCalculator;
 class GateDigitizer;
+class G4VPhysicalVolume;
 
 //-----------------------------------------------------------------------------
 class GateComptonCameraActor : public GateVActor
@@ -170,7 +172,14 @@ protected:
   double edptempAb;
 
   G4String processPostStep;
-  G4String VolNameStep;
+  G4int VolIndexStep;
+
+  //Names of the step volumes (volume name without "_phys" plus copy number, as the layer names)
+  //built once per physical volume and copy number instead of at each step
+  G4int GetStepVolumeIndex(const G4VPhysicalVolume* volume);
+  std::map<std::pair<const G4VPhysicalVolume*,G4int>,G4int> mStepVolumeIndex;
+  std::vector<G4String> mStepVolumeNames;
+  std::vector<bool> mStepVolumeIsLayer;
   G4int evtID;
   G4int runID;
 
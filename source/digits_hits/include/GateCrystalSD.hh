@@ -83,7 +83,7 @@ class GateCrystalSD : public G4VSensitiveDetector
       //! next methods are for the multi-system approach
       inline GateSystemList* GetSystemList() const { return m_systemList; }
       void AddSystem(GateVSystem* aSystem);
-      GateVSystem* FindSystem(GateVolumeID volumeID);
+      GateVSystem* FindSystem(const GateVolumeID& volumeID);
       GateVSystem* FindSystem(G4String& systemName);
 
       G4int PrepareCreatorAttachment(GateVVolume* aCreator);
@@ -105,6 +105,10 @@ class GateCrystalSD : public G4VSensitiveDetector
       G4double m_sourceEnergy;
       G4int  m_sourcePDG;
 
+      //! System and output volumeID handle of each volumeID handle, computed the first time the volume is hit
+      std::vector<GateVSystem*> m_systemOfVolume;
+      std::vector<G4int>        m_outputVolumeIDOfVolume;
+
 };
 
 
@@ -29,6 +29,8 @@ See LICENSE.md for further details
 
 #include "GateVolumeID.hh"
 #include "GateOutputVolumeID.hh"
+#include "GateVolumeIDTable.hh"
+#include "GateStringTable.hh"
 #include "GateVSystem.hh"
 
 
@@ -109,14 +111,18 @@ public:
       inline void  SetNCrystalRayleigh(G4int j)  { m_nCrystalRayleigh = j; }
       inline G4int GetNCrystalRayleigh() const        { return m_nCrystalRayleigh; }
 
-      inline void     SetComptonVolumeName(const G4String& name) { m_comptonVolumeName = name; }
-      inline G4String GetComptonVolumeName() const        { return m_comptonVolumeName; }
+      inline void     SetComptonVolumeName(const G4String& name) { m_comptonVolumeNameHandle = GateStringTable::GetInstance()->GetHandle(name); }
+      inline const G4String& GetComptonVolumeName() const { return GateStringTable::GetInstance()->GetString(m_comptonVolumeNameHandle); }
 
-      inline void     SetRayleighVolumeName(const G4String& name) { m_RayleighVolumeName = name; }
-      inline G4String GetRayleighVolumeName() const        { return m_RayleighVolumeName; }
+      inline void     SetRayleighVolumeName(const G4String& name) { m_RayleighVolumeNameHandle = GateStringTable::GetInstance()->GetHandle(name); }
+      inline const G4String& GetRayleighVolumeName() const { return GateStringTable::GetInstance()->GetString(m_RayleighVolumeNameHandle); }
 
-      inline void  SetVolumeID(const GateVolumeID& volumeID)            { m_volumeID = volumeID; }
-      inline const GateVolumeID& GetVolumeID() const                  	{ return m_volumeID; }
+      inline void  SetVolumeID(const GateVolumeID& volumeID)
+      	  { m_volumeIDHandle = GateVolumeIDTable::GetInstance()->GetVolumeIDHandle(volumeID); }
+      inline const GateVolumeID& GetVolumeID() const
+      	  { return GateVolumeIDTable::GetInstance()->GetVolumeID(m_volumeIDHandle); }
+      inline void  SetVolumeIDHandle(G4int handle)                    { m_volumeIDHandle = handle; }
+      inline G4int GetVolumeIDHandle() const                          { return m_volumeIDHandle; }
 
       inline void  SetScannerPos(const G4ThreeVector& xyz)            	{ m_scannerPos = xyz; }
       inline const G4ThreeVector& GetScannerPos() const                   	{ return m_scannerPos; }
@@ -124,9 +130,15 @@ public:
       inline void     SetScannerRotAngle(G4double angle)      	        { m_scannerRotAngle = angle; }
       inline G4double GetScannerRotAngle() const                   	      	{ return m_scannerRotAngle; }
 
-      inline void  SetOutputVolumeID(const GateOutputVolumeID& outputVolumeID)        	{ m_outputVolumeID = outputVolumeID; }
-      inline const GateOutputVolumeID& GetOutputVolumeID()  const             	      	{ return m_outputVolumeID; }
-      inline G4int GetComponentID(size_t depth) const    { return (m_outputVolumeID.size()>depth) ? m_outputVolumeID[depth] : -1; }
+      inline void  SetOutputVolumeID(const GateOutputVolumeID& outputVolumeID)
+      	  { m_outputVolumeIDHandle = GateVolumeIDTable::GetInstance()->GetOutputVolumeIDHandle(outputVolumeID); }
+      inline const GateOutputVolumeID& GetOutputVolumeID()  const
+      	  { return GateVolumeIDTable::GetInstance()->GetOutputVolumeID(m_outputVolumeIDHandle); }
+      inline void  SetOutputVolumeIDHandle(G4int handle)              { m_outputVolumeIDHandle = handle; }
+      inline G4int GetOutputVolumeIDHandle() const                    { return m_outputVolumeIDHandle; }
+      inline G4int GetComponentID(size_t depth) const
+      	  { const GateOutputVolumeID& outputVolumeID = GetOutputVolumeID();
+      	    return (outputVolumeID.size()>depth) ? outputVolumeID[depth] : -1; }
 
       inline void  SetSystemID(const G4int systemID) { m_systemID = systemID; }
       inline G4int GetSystemID() const { return m_systemID; }
@@ -145,8 +157,8 @@ public:
 
 
       // AE : Added for IdealComptonPhot adder which take into account several Comptons in the same volume
-      inline void     SetPostStepProcess(G4String proc) { m_Postprocess = proc; }
-      inline G4String GetPostStepProcess() const             { return m_Postprocess; }
+      inline void     SetPostStepProcess(const G4String& proc) { m_postStepProcessHandle = GateStringTable::GetInstance()->GetHandle(proc); }
+      inline const G4String& GetPostStepProcess() const { return GateStringTable::GetInstance()->GetString(m_postStepProcessHandle); }
 
       inline void SetEnergyIniTrack(G4double eIni)          { m_energyIniTrack = eIni; }
       inline G4double GetEnergyIniTrack() const                { return m_energyIniTrack; }
@@ -164,8 +176,8 @@ public:
       inline G4int GetNCrystalConv() const                { return m_nCrystalConv; }
 
 
-      inline void     SetProcessCreator(G4String proc) { m_processCreator = proc; }
-      inline G4String GetProcessCreator() const             { return m_processCreator; }
+      inline void     SetProcessCreator(const G4String& proc) { m_processCreatorHandle = GateStringTable::GetInstance()->GetHandle(proc); }
+      inline const G4String& GetProcessCreator() const { return GateStringTable::GetInstance()->GetString(m_processCreatorHandle); }
 
       inline void SetTrackID(G4int trkID)          { m_trackID = trkID; }
       inline G4int GetTrackID() const                { return m_trackID; }
@@ -218,12 +230,12 @@ public:
   G4int m_nCrystalCompton;    	  //!< # of compton processes in the crystal occurred to the photon
   G4int m_nPhantomRayleigh;    	  //!< # of Rayleigh processes in the phantom occurred to the photon
   G4int m_nCrystalRayleigh;    	  //!< # of Rayleigh processes in the crystal occurred to the photon
-  G4String m_comptonVolumeName;   //!< name of the volume of the last (if any) compton scattering
-  G4String m_RayleighVolumeName;   //!< name of the volume of the last (if any) Rayleigh scattering
-  GateVolumeID m_volumeID;        //!< Volume ID in the world volume tree
+  G4int m_comptonVolumeNameHandle;  //!< name of the volume of the last (if any) compton scattering (handle in the GateStringTable)
+  G4int m_RayleighVolumeNameHandle; //!< name of the volume of the last (if any) Rayleigh scattering (handle in the GateStringTable)
+  G4int m_volumeIDHandle;         //!< Volume ID in the world volume tree (handle in the GateVolumeIDTable)
   G4ThreeVector m_scannerPos; 	  //!< Position of the scanner
   G4double m_scannerRotAngle; 	  //!< Rotation angle of the scanner
-  GateOutputVolumeID m_outputVolumeID;
+  G4int m_outputVolumeIDHandle;   //!< Output volume ID (handle in the GateVolumeIDTable)
   G4int m_systemID;           // system ID in for the multi-system approach
 
   #ifdef GATE_USE_OPTICAL
@@ -233,10 +245,10 @@ public:
 
   // AE : Added for IdealComptonPhot adder which take into account several Comptons in the same volume
   //These variables no sense for a general pulse but I need them to  process idealy the hits. or create another structure
-  G4String m_Postprocess;         // PostStep process
+  G4int m_postStepProcessHandle;  // PostStep process (handle in the GateStringTable)
   G4double m_energyIniTrack;         // Initial energy of the track
   G4double m_energyFin;         // final energy of the particle
-  G4String m_processCreator;
+  G4int m_processCreatorHandle;   // (handle in the GateStringTable)
   G4int m_trackID;
   G4int m_parentID;
 
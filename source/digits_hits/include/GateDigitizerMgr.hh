@@ -29,6 +29,7 @@
 #include "GateTools.hh"
 #include "GateCrystalSD.hh"
 #include "G4DigiManager.hh"
+#include "CLHEP/Random/RandomEngine.h"
 #include "GateCoincidenceSorter.hh"
 
 #include "GateDigitizerInitializationModule.hh"
@@ -105,6 +106,12 @@ public:
    GateCoincidenceDigitizer* FindCoincidenceDigitizer(G4String mName);
    /// End of methods for Coincidences
 
+   //! Each singles digitizer, coincidence sorter and coincidence digitizer draws its random numbers
+   //! from its own engine, seeded from the main seed and its name: its blurring does not depend
+   //! on the other chains (see GateRandomEngine::CreateStreamEngine())
+   inline void SetChainRandomStreams(G4bool val) { m_chainRandomStreams = val; }
+   inline G4bool GetChainRandomStreams() const { return m_chainRandomStreams; }
+
 private:
 
 
@@ -134,6 +141,15 @@ public:
 
   G4bool m_alreadyRun;
 
+private:
+  //! Creates the engines of the chains (when the chain random streams are enabled)
+  void InitializeChainRandomStreams();
+
+  G4bool m_chainRandomStreams;
+  std::vector<CLHEP::HepRandomEngine*> m_singlesDigitizerEngines;
+  std::vector<CLHEP::HepRandomEngine*> m_coincidenceSorterEngines;
+  std::vector<CLHEP::HepRandomEngine*> m_coincidenceDigitizerEngines;
+
 
 };
 #endif
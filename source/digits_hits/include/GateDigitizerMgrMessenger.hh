@@ -79,6 +79,7 @@ private:
   G4UIcmdWithoutParameter*    ListCmd;	      //!< the UI command 'list'
   G4UIcmdWithAString*         pInsertCmd;	      //!< the UI command 'insert'
   G4UIcmdWithAString* 		  SetChooseSDCmd;     //!< the UI command 'chooseSD'
+  G4UIcmdWithABool*           SetChainRandomStreamsCmd; //!< the UI command 'setChainRandomStreams'
 private:
   G4String  	      	m_newCollectionName; //m_newInsertionBaseName  //!< the name to be given to the next insertion
   	  	  	  	  	  	  	  	  	  	  	  	  //!< (if empty, the type-name will be used)
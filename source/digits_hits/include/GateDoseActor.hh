@@ -76,6 +76,7 @@ public:
   void SetDoseAlgorithmType(G4String b) { mDoseAlgorithmType = b; }
   void ImportMassImage(G4String b) { mImportMassImage = b; }
   void ExportMassImage(G4String b) { mExportMassImage = b; }
+  void SetMassCacheDirectory(G4String b) { mMassCacheDirectory = b; }
   void VolumeFilter(G4String b) { mVolumeFilter = b; }
   void MaterialFilter(G4String b) { mMaterialFilter = b; }
   void setTestFlag(bool b) { mTestFlag = b; }
@@ -86,6 +87,7 @@ public:
 
   virtual void BeginOfRunAction(const G4Run*r);
   virtual void BeginOfEventAction(const G4Event * event);
+  virtual void EndOfEventAction(const G4Event * event);
 
   virtual void UserSteppingActionInVoxel(const int index, const G4Step* step);
   virtual void UserPreTrackActionInVoxel(const int /*index*/, const G4Track* track);
@@ -107,8 +109,6 @@ protected:
   int mCurrentEvent;
   StepHitType mUserStepHitType;
 
-  bool mIsLastHitEventImageEnabled;
-
   //Edep
   bool mIsEdepImageEnabled;
   bool mIsEdepSquaredImageEnabled;
@@ -160,7 +160,6 @@ protected:
   //Hits
   G4String mNbOfHitsFilename;
   GateImageInt mNumberOfHitsImage;
-  GateImageInt mLastHitEventImage;
   //Others
   GateImageDouble mMassImage;
   //Regions
@@ -175,6 +174,7 @@ protected:
   G4String mDoseAlgorithmType;
   G4String mImportMassImage;
   G4String mExportMassImage;
+  G4String mMassCacheDirectory;
   G4String mVolumeFilter;
   G4String mMaterialFilter;
 
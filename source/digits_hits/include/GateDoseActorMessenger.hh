@@ -64,6 +64,7 @@ protected:
   G4UIcmdWithAString * pSetDoseAlgorithmCmd;
   G4UIcmdWithAString * pImportMassImageCmd;
   G4UIcmdWithAString * pExportMassImageCmd;
+  G4UIcmdWithAString * pSetMassCacheDirectoryCmd;
   G4UIcmdWithAString * pVolumeFilterCmd;
   G4UIcmdWithAString * pMaterialFilterCmd;
   G4UIcmdWithABool * pTestFlagCmd;
@@ -45,6 +45,9 @@ public:
   
   void Digitize() override;
 
+  G4bool IsInPlaceCapable() const override { return true; }
+  void DigitizeInPlace(std::vector<GateDigi*>& digis) override;
+
   void SetMin(G4double val)   { m_min = val;  }
   G4double GetMin()   	      { return m_min; }
 
@@ -43,6 +43,9 @@ public:
 
   void Digitize() override;
 
+  G4bool IsInPlaceCapable() const override { return true; }
+  void DigitizeInPlace(std::vector<GateDigi*>& digis) override;
+
   void SetResolution(G4double val)   { m_reso = val;  }
   void SetResolutionMin(G4double val)   { m_resoMin = val;  }
   void SetResolutionMax(G4double val)   { m_resoMax = val;  }
@@ -60,6 +63,10 @@ protected:
   G4double m_slope;
 
 private:
+  void CheckResolutionParameters() const;
+  //! Returns the energy blurred with the resolution at this energy
+  G4double BlurEnergy(G4double energy) const;
+
   GateDigi* m_outputDigi;
   GateEnergyResolutionMessenger *m_Messenger;
   GateDigiCollection*  m_OutputDigiCollection;
@@ -68,6 +68,7 @@ public:
   }
   virtual void BeginOfRunAction(const G4Run *);
   virtual void BeginOfEventAction(const G4Event * e);
+  virtual void EndOfEventAction(const G4Event * e);
   virtual void UserSteppingActionInVoxel(const int index, const G4Step* step);
   virtual void UserPreTrackActionInVoxel(const int /*index*/,
                                          const G4Track* /*t*/)
@@ -106,7 +107,6 @@ protected:
 
   GateImageWithStatistic mImage;
   GateImageWithStatistic mImageProcess;
-  GateImage mLastHitEventImage;
   GateImage mNumberOfHitsImage;
   GateImageDouble mStepLengthImage;
   GateImageDouble mNumberOfHitsStepLengthImage;
@@ -116,7 +116,6 @@ protected:
   GateFluenceActorMessenger * pMessenger;
 
   int mCurrentEvent;
-  bool mIsLastHitEventImageEnabled;
   bool mIsStepLengthImageEnabled;
   bool mIsSquaredImageEnabled;
   bool mIsUncertaintyImageEnabled;
@@ -23,6 +23,8 @@ See LICENSE.md for further details
 
 #include "GateVolumeID.hh"
 #include "GateOutputVolumeID.hh"
+#include "GateVolumeIDTable.hh"
+#include "GateStringTable.hh"
 
 /*! \class  GateHit
     \brief  Stores hit information for a hit taking place in a volume connected to a system
@@ -67,7 +69,7 @@ public:
   G4double m_posz;
   G4ThreeVector m_momDir;        // momentum Direction of the current hit
   G4ThreeVector m_localPos;   // position of the current hit
-  G4String m_process;         // process on the current hit
+  G4int m_processHandle;      // process on the current hit (handle in the GateStringTable)
   G4int m_PDGEncoding;        // G4 PDGEncoding
   G4int m_trackID;            // track ID
   G4int m_parentID;           // parent track ID
@@ -78,15 +80,15 @@ public:
   G4int m_nCrystalCompton;    // # of compton processes in the crystal occurred to the photon
   G4int m_nPhantomRayleigh;    // # of Rayleigh processes in the phantom occurred to the photon
   G4int m_nCrystalRayleigh;    // # of Rayleigh processes in the crystal occurred to the photon
-  G4String m_comptonVolumeName; // name of the volume of the last (if any) compton scattering
-  G4String m_RayleighVolumeName; // name of the volume of the last (if any) Rayleigh scattering
+  G4int m_comptonVolumeNameHandle; // name of the volume of the last (if any) compton scattering (handle in the GateStringTable)
+  G4int m_RayleighVolumeNameHandle; // name of the volume of the last (if any) Rayleigh scattering (handle in the GateStringTable)
   G4int m_primaryID;          // primary that caused the hit
   G4int m_eventID;            // eventID
   G4int m_runID;              // runID
-  GateVolumeID m_volumeID;    // Volume ID in the world volume tree
+  G4int m_volumeIDHandle;     // Volume ID in the world volume tree (handle in the GateVolumeIDTable)
   G4ThreeVector m_scannerPos; // Position of the scanner
   G4double m_scannerRotAngle; // Rotation angle of the scanner
-  GateOutputVolumeID m_outputVolumeID;
+  G4int m_outputVolumeIDHandle; // Output volume ID (handle in the GateVolumeIDTable)
   G4int m_systemID;           // system ID in for the multi-system approach
 
   // To use with GateROOTBasicOutput classes
@@ -97,7 +99,7 @@ public:
 
 
 // AE : Added for IdealComptonPhot adder which take into account several Comptons in the same volume
-  G4String m_Postprocess;         // PostStep process 
+  G4int m_postStepProcessHandle; // PostStep process (handle in the GateStringTable)
   G4double m_energyIniTrack;         // Initial energy of the track
   G4double m_energyFin;         // final energy of the particle
   G4double m_sourceEnergy;//AE
@@ -137,8 +139,8 @@ public:
       inline const G4ThreeVector& GetLocalPos() const             { return m_localPos; }
 
 
-      inline void     SetProcess(G4String proc) { m_process = proc; }
-      inline G4String GetProcess() const             { return m_process; }
+      inline void     SetProcess(const G4String& proc) { m_processHandle = GateStringTable::GetInstance()->GetHandle(proc); }
+      inline const G4String& GetProcess() const      { return GateStringTable::GetInstance()->GetString(m_processHandle); }
 
       inline void  SetPDGEncoding(G4int j)      { m_PDGEncoding = j; }
       inline G4int GetPDGEncoding() const            { return m_PDGEncoding; }
@@ -170,11 +172,11 @@ public:
       inline void  SetNCrystalRayleigh(G4int j)  { m_nCrystalRayleigh = j; }
       inline G4int GetNCrystalRayleigh() const        { return m_nCrystalRayleigh; }
 
-      inline void     SetComptonVolumeName(G4String name) { m_comptonVolumeName = name; }
-      inline G4String GetComptonVolumeName() const        { return m_comptonVolumeName; }
+      inline void     SetComptonVolumeName(const G4String& name) { m_comptonVolumeNameHandle = GateStringTable::GetInstance()->GetHandle(name); }
+      inline const G4String& GetComptonVolumeName() const { return GateStringTable::GetInstance()->GetString(m_comptonVolumeNameHandle); }
 
-      inline void     SetRayleighVolumeName(G4String name) { m_RayleighVolumeName = name; }
-      inline G4String GetRayleighVolumeName() const        { return m_RayleighVolumeName; }
+      inline void     SetRayleighVolumeName(const G4String& name) { m_RayleighVolumeNameHandle = GateStringTable::GetInstance()->GetHandle(name); }
+      inline const G4String& GetRayleighVolumeName() const { return GateStringTable::GetInstance()->GetString(m_RayleighVolumeNameHandle); }
 
       inline void  SetPrimaryID(G4int j)        { m_primaryID = j; }
       inline G4int GetPrimaryID() const              { return m_primaryID; }
@@ -185,8 +187,12 @@ public:
       inline void  SetRunID(G4int j)            { m_runID = j; }
       inline G4int GetRunID() const                  { return m_runID; }
 
-      inline void  SetVolumeID(const GateVolumeID& volumeID)            { m_volumeID = volumeID; }
-      inline const GateVolumeID& GetVolumeID() const                  	{ return m_volumeID; }
+      inline void  SetVolumeID(const GateVolumeID& volumeID)
+      	  { m_volumeIDHandle = GateVolumeIDTable::GetInstance()->GetVolumeIDHandle(volumeID); }
+      inline const GateVolumeID& GetVolumeID() const
+      	  { return GateVolumeIDTable::GetInstance()->GetVolumeID(m_volumeIDHandle); }
+      inline void  SetVolumeIDHandle(G4int handle)                    { m_volumeIDHandle = handle; }
+      inline G4int GetVolumeIDHandle() const                          { return m_volumeIDHandle; }
 
       inline void  SetScannerPos(const G4ThreeVector& xyz)            	{ m_scannerPos = xyz; }
       inline const G4ThreeVector& GetScannerPos() const                   	{ return m_scannerPos; }
@@ -194,15 +200,22 @@ public:
       inline void     SetScannerRotAngle(G4double angle)      	        { m_scannerRotAngle = angle; }
       inline G4double GetScannerRotAngle() const                   	      	{ return m_scannerRotAngle; }
 
-      inline void  SetOutputVolumeID(const GateOutputVolumeID& outputVolumeID)  { m_outputVolumeID = outputVolumeID; }
-      inline const GateOutputVolumeID& GetOutputVolumeID()  const             	{ return m_outputVolumeID; }
-      inline G4int GetComponentID(size_t depth) const    { return (m_outputVolumeID.size()>depth) ? m_outputVolumeID[depth] : -1; }
+      inline void  SetOutputVolumeID(const GateOutputVolumeID& outputVolumeID)
+      	  { m_outputVolumeIDHandle = GateVolumeIDTable::GetInstance()->GetOutputVolumeIDHandle(outputVolumeID); }
+      inline const GateOutputVolumeID& GetOutputVolumeID()  const
+      	  { return GateVolumeIDTable::GetInstance()->GetOutputVolumeID(m_outputVolumeIDHandle); }
+      inline void  SetOutputVolumeIDHandle(G4int handle)              { m_outputVolumeIDHandle = handle; }
+      inline G4int GetOutputVolumeIDHandle() const                    { return m_outputVolumeIDHandle; }
+      inline G4int GetComponentID(size_t depth) const
+      	  { const GateOutputVolumeID& outputVolumeID = GetOutputVolumeID();
+      	    return (outputVolumeID.size()>depth) ? outputVolumeID[depth] : -1; }
 
       inline void  SetSystemID(const G4int systemID) { m_systemID = systemID; }
       inline G4int GetSystemID() const { return m_systemID; }
 
       inline G4bool GoodForAnalysis() const
-      	  { return ( (m_process != "Transportation") || (m_edep!=0.) ); }
+      	  { static const G4int transportation = GateStringTable::GetInstance()->GetHandle("Transportation");
+      	    return ( (m_processHandle != transportation) || (m_edep!=0.) ); }
 
       // HDS : Added in order to record septal penetration
       inline void  SetNSeptal(G4int j)  { m_nSeptal = j; }
@@ -212,8 +225,8 @@ public:
 
 
       // AE : Added for IdealComptonPhot adder which take into account several Comptons in the same volume 
-      inline void     SetPostStepProcess(G4String proc) { m_Postprocess = proc; }
-      inline G4String GetPostStepProcess() const             { return m_Postprocess; }
+      inline void     SetPostStepProcess(const G4String& proc) { m_postStepProcessHandle = GateStringTable::GetInstance()->GetHandle(proc); }
+      inline const G4String& GetPostStepProcess() const { return GateStringTable::GetInstance()->GetString(m_postStepProcessHandle); }
      
       inline void SetEnergyIniTrack(G4double eIni)          { m_energyIniTrack = eIni; }
       inline G4double GetEnergyIniTrack() const                { return m_energyIniTrack; }
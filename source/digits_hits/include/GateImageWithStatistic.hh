@@ -18,6 +18,8 @@ See LICENSE.md for further details
 #define GATEIMAGEWITHSTATISTIC_HH
 
 #include "GateImage.hh"
+#include "GateSparseImageT.hh"
+#include <vector>
 
 //-----------------------------------------------------------------------------
 /// \brief
@@ -39,8 +41,14 @@ class GateImageWithStatistic
   void Allocate();
   void Reset(double val=0.0);
 
+  // History-by-history statistics: the values of the current event are summed
+  // in the temporary image with AddTempValue, then EndOfEvent adds them (and
+  // their squares) to the accumulators. Only the voxels touched during the
+  // event are visited. AddValueAndUpdate folds the previous value of a single
+  // voxel, for actors that detect the first hit of an event themselves.
   void AddTempValue(const int index, double value);
   void AddValueAndUpdate(const int index, double value);
+  void EndOfEvent();
   void AddValue(const int index, double value);
 
   double GetValue(const int index);
@@ -49,6 +57,13 @@ class GateImageWithStatistic
 
   void EnableSquaredImage(bool b)     { mIsSquaredImageEnabled = b; }
   void EnableUncertaintyImage(bool b) { mIsUncertaintyImageEnabled = b; }
+  // The values of the current event are stored in single precision (the
+  // run accumulators stay in double precision). Must be set before Allocate.
+  void EnableSinglePrecisionTempImage(bool b) { mIsSinglePrecisionTempImageEnabled = b; }
+  // The images are stored as bricks allocated on first touch (see
+  // GateSparseImageT), for large and mostly empty grids. Must be set before
+  // SetResolutionAndHalfSize. The temporary image is then always double.
+  void EnableSparseImages(bool b) { mIsSparseImageEnabled = b; }
   void SetScaleFactor(double s);
   void SetNormalizeToMax(bool b)      { mNormalizedToMax = b; mNormalizedToIntegral = !b; }
   void SetNormalizeToIntegral(bool b) { mNormalizedToMax = !b; mNormalizedToIntegral = b; }
@@ -56,32 +71,77 @@ class GateImageWithStatistic
   void SetFilename(G4String f);
   void SaveData(int numberOfEvents, bool normalise=false);
 
-  inline G4double GetVoxelVolume() const { return mValueImage.GetVoxelVolume(); }
+  inline G4double GetVoxelVolume() const {
+    if (mIsSparseImageEnabled) return mSparseValueImage.GetVoxelVolume();
+    return mValueImage.GetVoxelVolume();
+  }
 
-  virtual void UpdateImage();
-  virtual void UpdateSquaredImage();
   virtual void UpdateUncertaintyImage(int numberOfEvents);
 
-  GateVImage & GetValueImage() { return mValueImage; }
-  GateVImage & GetUncertaintyImage() { return mUncertaintyImage; }
+  GateVImage & GetValueImage() {
+    if (mIsSparseImageEnabled) return mSparseValueImage;
+    return mValueImage;
+  }
+  GateVImage & GetUncertaintyImage() {
+    if (mIsSparseImageEnabled) return mSparseUncertaintyImage;
+    return mUncertaintyImage;
+  }
+
+  // Memory (bytes) of the images kept during the run, and of the scaled and
+  // uncertainty images, only allocated (one at a time) while SaveData runs.
+  unsigned long GetMemorySize() const;
+  unsigned long GetTransientMemorySize() const;
 
   void SetOrigin(G4ThreeVector v);
   void SetOverWriteFilesFlag(bool b) { mOverWriteFilesFlag = b; }
   void SetTransformMatrix(const G4RotationMatrix & m);
 
+  // Merge of forked processes (/gate/application/setNumberOfProcesses).
+  // All instances are listed in construction order, which is the same in every process.
+  // Each process writes the touched blocks of its accumulators; the parent adds them
+  // in process order, so the merged images do not depend on process completion order.
+  static void WriteAccumulatorsOfAllImages(const G4String & filename);
+  static void AddAccumulatorsOfAllImages(const G4String & filename);
+  static int SaveAllMergedImages();
+
   protected:
+  static std::vector<GateImageWithStatistic*> mListOfImages;
+  static constexpr unsigned long mBlockSize = 4096;
+  static void WriteTouchedBlocks(GateImageDouble & image, std::ostream & os);
+  static void AddTouchedBlocks(GateImageDouble & image, std::istream & is, const G4String & filename);
+  static void WriteScaledImage(const GateImageDouble & image, GateImageDouble & scaledImage,
+                               double scale, const G4String & filename);
+  static void WriteAllocatedBricks(GateSparseImageDouble & image, std::ostream & os);
+  static void AddAllocatedBricks(GateSparseImageDouble & image, std::istream & is, const G4String & filename);
+  static void WriteScaledImage(const GateSparseImageDouble & image, GateSparseImageDouble & scaledImage,
+                               double scale, const G4String & filename);
+  void SaveSparseData(int numberOfEvents, bool normalise, double factor);
+  bool mIsSaved;
+  bool mLastNormalise;
+  long mLastNumberOfEvents;
+
   GateImageDouble mValueImage;
   GateImageDouble mSquaredImage;
   GateImageDouble mTempImage;
+  GateImage mSinglePrecisionTempImage;
   GateImageDouble mUncertaintyImage;
   GateImageDouble mScaledValueImage;
   GateImageDouble mScaledSquaredImage;
+  GateSparseImageDouble mSparseValueImage;
+  GateSparseImageDouble mSparseSquaredImage;
+  GateSparseImageDouble mSparseTempImage;
+  GateSparseImageDouble mSparseUncertaintyImage;
+  GateSparseImageDouble mSparseScaledImage;
+  // Voxels of the temporary image that may be non zero
+  std::vector<int> mTouchedVoxels;
   bool mOverWriteFilesFlag;
   bool mNormalizedToMax;
   bool mNormalizedToIntegral;
 
   bool mIsSquaredImageEnabled;
   bool mIsUncertaintyImageEnabled;
+  bool mIsSinglePrecisionTempImageEnabled;
+  bool mIsSparseImageEnabled;
   bool mIsValuesMustBeScaled;
 
   double mScaleFactor;
@@ -78,6 +78,7 @@ protected:
   bool mIsLETtoWaterEnabled;
   G4String mAveragingType;
   G4String mSetMaterial;
+  const G4Material * mSetMaterialDefinition;
   
   GateImageDouble mWeightedLETImage;
   GateImageDouble mNormalizationLETImage;
@@ -115,8 +116,6 @@ protected:
 
   bool mIsParallelCalculationEnabled;
 
-  G4EmCalculator * emcalc;
-  
   StepHitType mUserStepHitType;
 };
 
@@ -22,6 +22,8 @@
 #include <TFile.h>
 #include <TH1.h>
 #include <TH2.h>
+#include <utility>
+#include <vector>
 
 //-----------------------------------------------------------------------------
 class GatePromptGammaTLEActor: public GateVImageActor
@@ -36,7 +38,7 @@ public:
   virtual void UserPostTrackActionInVoxel(const int index, const G4Track* t);
   virtual void UserSteppingActionInVoxel(const int index, const G4Step* step);
   virtual void BeginOfEventAction(const G4Event * e);
-  //virtual void EndOfEventAction(const G4Event * e);
+  virtual void EndOfEventAction(const G4Event * e);
 
   void SetInputDataFilename(std::string filename);
   virtual void SaveData();
@@ -65,8 +67,9 @@ protected:
   void BuildVarianceOutput(); //converts trackl,tracklsq into mImageGamma and tlevar per voxel. Not used.
   //void BuildSysVarianceOutput(); //converts trackl into mImageGamma and tlesysvarv. Not used.
 
-  //used and reset each track
+  //used and reset each event
   GateImageOfHistograms * tmptrackl;    //l_i
+  std::vector<std::pair<int,int> > mTouchedBins; //(voxel, bin) of tmptrackl touched in the event
 
   //updated at end of event:
   GateImageOfHistograms * trackl;       //L_i. also intermediate output: track length per voxel per E_proton
@@ -78,7 +81,6 @@ protected:
   GateImageOfHistograms * tlesysvar;    //systematic variance per voxel, per E_gamma. Not used.
   GateImageOfHistograms * tlevariance;  //uncertainty per voxel, per E_gamma. Not used.
 
-  GateImageInt mLastHitEventImage;      //store eventID when last updated.
   int mCurrentEvent;                    //monitor event. TODO: not sure if necesary
 };
 //-----------------------------------------------------------------------------
@@ -51,6 +51,7 @@ See LICENSE.md for further details
 #include "globals.hh"
 #include <iostream>
 #include <vector>
+#include <unordered_map>
 #include "G4ThreeVector.hh"
 
 #include "GateVPulseProcessor.hh"
@@ -140,6 +141,9 @@ private:
   GateDigiCollection*  m_OutputDigiCollection;
   GateSinglesDigitizer *m_digitizer;
 
+  //! Position of the output digi of each block in the temporary output list, keyed by GateOutputVolumeID::GetHashKey()
+  std::unordered_map<size_t, G4int> m_outputDigiIndex;
+
 
 };
 
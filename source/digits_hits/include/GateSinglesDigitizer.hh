@@ -90,6 +90,17 @@ class GateSinglesDigitizer : public GateModuleListManager
     //corresponding to the last DM output ID. Used by output modules to find what to write down
     void SetOutputCollectionID();
 
+    //! In-place chain: the digis of the event are copied once from the input collection and
+    //! transformed in place by the DMs that support it (see GateVDigitizerModule::DigitizeInPlace()).
+    //! A collection is only created for the output of the digitizer and for the input of the
+    //! DMs without in-place support.
+    void SetInPlaceChain(G4bool val)
+      { m_inPlaceChain = val; }
+    G4bool IsInPlaceChain() const
+      { return m_inPlaceChain; }
+    //! Runs all DMs of this digitizer as an in-place chain
+    void RunInPlaceChain();
+
 
 
  protected:
@@ -97,6 +108,8 @@ class GateSinglesDigitizer : public GateModuleListManager
       GateVSystem *m_system;            //!< System to which the digitizer is attached
       G4String				   m_outputName;
       G4String                 m_inputName;
+      G4bool                   m_inPlaceChain;
+      std::vector<GateDigi*>   m_chainDigis;       //!< Digis of the event in an in-place chain
 
 public:
       G4bool                m_recordFlag;
@@ -67,6 +67,7 @@ class GateSinglesDigitizerMessenger: public GateListMessenger
   private:
 
     G4UIcmdWithAString*         SetInputNameCmd;        //!< The UI command "set input name"
+    G4UIcmdWithABool*           SetInPlaceChainCmd;     //!< The UI command "set in-place chain"
     GateSinglesDigitizer* m_digitizer;
 };
 
@@ -21,6 +21,7 @@ See LICENSE.md for further details
 #include "GateConfiguration.h"
 #include "globals.hh"
 #include <fstream>
+#include <vector>
 
 /*! \class  GateSinogram
     \brief  Structure to store the sinogram sets from a PET simulation
@@ -30,6 +31,10 @@ See LICENSE.md for further details
     - This structure is generated during a PET simulation by GateToSinogram. It can be stored
       into an output file using a set-writer such as GateSinoToEcat7
 
+    - A 2D sinogram is only allocated when its first coincidence is stored: with many rings,
+      most ring pairs of large ring difference are never hit. The sinograms that are not
+      allocated read as a shared sinogram of zeros.
+
     \sa GateToSinogram, GateSinoToEcat7
 */
 class GateSinogram
@@ -61,6 +66,15 @@ class GateSinogram
     //! Returns the 2D sino ID for a given pair of rings
     G4int GetSinoID( G4int ring1ID, G4int ring2ID);
 
+    //! Returns the number of 2D sinograms that have been allocated
+    size_t GetAllocatedSinogramNb() const;
+
+  private:
+    //! Computes the 2D sino ID of a pair of rings (the IDs are tabulated by Reset())
+    G4int ComputeSinoID( G4int ring1ID, G4int ring2ID) const;
+
+  public:
+
     //! \name getters and setters
     //@{
 
@@ -121,9 +135,9 @@ class GateSinogram
     virtual void SetVerboseLevel(G4int val)
       { nVerboseLevel = val; };
 
-    //! Returns a 2D sinogram from the set
+    //! Returns a 2D sinogram from the set (the sinogram of zeros if nothing was stored in it)
     inline SinogramDataType* GetSinogram(size_t sinoID) const
-      { return m_data[sinoID];}
+      { return m_data[sinoID] ? m_data[sinoID] : m_emptySinogram;}
 
     //! Returns the number of pixels per 2D sinogram
     inline G4int PixelsPerSinogram() const
@@ -168,7 +182,9 @@ class GateSinogram
 
     size_t                m_ringNb;                             //!< Nb of crystal rings
     size_t		  m_crystalNb;                          //!< Nb of crystals per crystal ring
-    SinogramDataType    **m_data;                               //!< Array of 2D sinograms
+    SinogramDataType    **m_data;                               //!< Array of 2D sinograms (0 until the sinogram is filled)
+    SinogramDataType     *m_emptySinogram;                      //!< Sinogram of zeros, returned for the sinograms not allocated
+    std::vector<G4int>    m_sinoIDTable;                        //!< 2D sino ID of each ring pair (ring1ID + ring2ID*m_ringNb)
     G4int                 m_currentFrameID;                     //!< ID of the current frame (dynamique acquisitions)
     G4int                 m_currentGateID;                      //!< ID of the current gate (synchronized acquisitions)
     G4int 	          m_currentDataID;                      //!< ID of the current coincidence type (prompts or trues, delayed, LowEnergy, ...)
@@ -196,6 +212,7 @@ inline GateSinogram::GateSinogram()
   : m_ringNb(0)
   , m_crystalNb(0)
   , m_data(0)
+  , m_emptySinogram(0)
   , m_currentFrameID(-1)
   , m_currentGateID(-1)
   , m_currentDataID(-1)
@@ -0,0 +1,99 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+
+/*!
+  \class  GateStoppingPowerTable
+  \brief  Tabulated stopping powers shared by the dose and LET actors
+
+  The dedx of a (particle, material, cut) is computed once with
+  G4EmCalculator on a log-spaced energy grid, then read back with a
+  linear interpolation in log(E). Tables of the ratio dedx(reference) /
+  dedx(material) (dose to water, LET to water) are stored the same way.
+  Tables are built lazily the first time a key is used and cleared with
+  Clear() at the beginning of each run. Energies outside of the grid
+  fall back to a direct G4EmCalculator call.
+*/
+
+#ifndef GATESTOPPINGPOWERTABLE_HH
+#define GATESTOPPINGPOWERTABLE_HH
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "globals.hh"
+
+class G4EmCalculator;
+class G4Material;
+class G4ParticleDefinition;
+
+class GateStoppingPowerTable
+{
+public:
+  ~GateStoppingPowerTable();
+
+  static GateStoppingPowerTable * GetInstance()
+  {
+    if (singleton_StoppingPowerTable == 0)
+      singleton_StoppingPowerTable = new GateStoppingPowerTable;
+    return singleton_StoppingPowerTable;
+  }
+
+  /// Remove all tables (physics or materials may change between runs)
+  void Clear();
+
+  /// Same as G4EmCalculator::ComputeTotalDEDX
+  G4double GetTotalDEDX(G4double energy, const G4ParticleDefinition * p,
+                        const G4Material * material, G4double cut);
+  /// Same as G4EmCalculator::ComputeElectronicDEDX
+  G4double GetElectronicDEDX(G4double energy, const G4ParticleDefinition * p,
+                             const G4Material * material, G4double cut);
+
+  /// dedx(reference)/dedx(material), 0 when one of the dedx is 0
+  G4double GetTotalDEDXRatio(G4double energy, const G4ParticleDefinition * p,
+                             const G4Material * material, const G4Material * reference,
+                             G4double cut);
+  G4double GetElectronicDEDXRatio(G4double energy, const G4ParticleDefinition * p,
+                                  const G4Material * material, const G4Material * reference,
+                                  G4double cut);
+
+protected:
+  GateStoppingPowerTable();
+
+  enum DEDXType { TotalDEDX, ElectronicDEDX };
+
+  // (type, particle, material, reference material or 0, cut)
+  typedef std::tuple<int, const G4ParticleDefinition *, const G4Material *,
+                     const G4Material *, G4double> Key;
+
+  G4double ComputeDEDX(DEDXType type, G4double energy, const G4ParticleDefinition * p,
+                       const G4Material * material, G4double cut);
+  G4double ComputeValue(DEDXType type, G4double energy, const G4ParticleDefinition * p,
+                        const G4Material * material, const G4Material * reference,
+                        G4double cut);
+  G4double GetValue(DEDXType type, G4double energy, const G4ParticleDefinition * p,
+                    const G4Material * material, const G4Material * reference,
+                    G4double cut);
+  const std::vector<G4double> & GetTable(const Key & key);
+
+  G4EmCalculator * mEmCalculator;
+  std::map<Key, std::vector<G4double> > mTables;
+  // Last table used, steps of a track are usually in the same material
+  Key mLastKey;
+  const std::vector<G4double> * mLastTable;
+
+  G4double mLogEnergyMin;
+  G4double mLogEnergyMax;
+  G4double mInverseLogStep;
+  int mNumberOfBins;
+
+  static GateStoppingPowerTable * singleton_StoppingPowerTable;
+};
+
+#endif /* end #define GATESTOPPINGPOWERTABLE_HH */
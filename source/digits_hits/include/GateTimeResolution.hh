@@ -40,6 +40,9 @@ public:
   
   void Digitize() override;
 
+  G4bool IsInPlaceCapable() const override { return true; }
+  void DigitizeInPlace(std::vector<GateDigi*>& digis) override;
+
 
   //! Returns the time resolution
   G4double GetFWHM()   	      { return m_fwhm; }
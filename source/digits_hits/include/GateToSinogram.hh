@@ -244,6 +244,13 @@ protected:
   // C. Comtat, February 2011: Required to simulate Biograph output sinograms with virtual crystals
   size_t              m_virtualRingPerBlockNb;     //! < Number of virtual axial crystals in one block, i.e. Biograph
   size_t              m_virtualCrystalPerBlockNb;  //! < Number of virtual transaxial crystals in one block, i.e. Biograph
+
+  // Geometry of the blocks and crystals, set at the beginning of the acquisition
+  G4int               m_blockAngularNb;           //!< Number of blocks per ring of blocks
+  G4int               m_crystalTransNb;           //!< Number of crystals per block in transaxial direction
+  G4int               m_crystalAxialNb;           //!< Number of crystals per block in axial direction
+  G4double            m_axialBlurring;            //!< FWHM of crystal location resolution in axial direction (in crystals)
+  G4double            m_tangBlurring;             //!< FWHM of crystal location resolution in tangential direction (in crystals)
   // std::ofstream     m_dataFile;   	      	   //!< Output stream for the data file
 
 };
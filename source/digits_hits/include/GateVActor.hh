@@ -114,6 +114,11 @@ public:
   void EnableResetDataAtEachRun(bool b) { mResetDataAtEachRun = b; }
   //-----------------------------------------------------------------------------
 
+  /// Memory (bytes) allocated by the actor for the whole run, and
+  /// temporarily while its data are saved
+  virtual unsigned long GetMemorySize() const { return 0; }
+  virtual unsigned long GetTransientMemorySize() const { return 0; }
+
   G4String GetVolumeName(){return mVolumeName;}
   GateVVolume * GetVolume(){return mVolume;}
   void SetVolumeName(G4String name){mVolumeName = name;}
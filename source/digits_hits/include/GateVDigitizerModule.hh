@@ -17,6 +17,7 @@ See LICENSE.md for further details
 #include "GateCrystalSD.hh"
 
 #include "globals.hh"
+#include <vector>
 #include "GateSinglesDigitizer.hh"
 #include "GateCoincidenceDigitizer.hh"
 
@@ -37,6 +38,13 @@ public:
   virtual void Digitize()=0;
   void InputCollectionID();
 
+  //! In-place chain (see GateSinglesDigitizer::RunInPlaceChain()):
+  //! returns true if the module implements DigitizeInPlace()
+  virtual G4bool IsInPlaceCapable() const { return false; }
+  //! Processes the digis of the event directly in the list of the chain, without input
+  //! or output collection. Rejected digis are deleted and removed from the list.
+  virtual void DigitizeInPlace(std::vector<GateDigi*>& digis);
+
   GateDigi* CentroidMerge(GateDigi* right, GateDigi* output );
   GateDigi* MergePositionEnergyWin(GateDigi *right, GateDigi *output);
 
@@ -62,6 +70,9 @@ private:
   //GateCoincidenceDigitizer *m_coinDigitizer;
 
 protected:
+  //! Deletes the digis for which keep is false and compacts the list (the order of the kept digis is unchanged)
+  static void RemoveRejectedDigis(std::vector<GateDigi*>& digis, const std::vector<G4bool>& keep);
+
   GateCrystalSD *m_SD;
   G4int m_outputDCID;
   G4int	m_InitDMID;
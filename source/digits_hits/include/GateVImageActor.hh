@@ -59,8 +59,16 @@ public :
   //void SetPosition(GateVVolume * v);
   /// Sets the type of the hit
   void SetStepHitType(G4String t);
+  /// Store the values of the current event in single precision
+  void EnableSinglePrecisionTempImage(bool b) { mIsSinglePrecisionTempImageEnabled = b; }
+  /// Store the images as bricks allocated on first touch
+  void EnableSparseImages(bool b) { mIsSparseImageEnabled = b; }
   //-----------------------------------------------------------------------------
 
+  /// Memory of the images given to SetOriginTransformAndFlagToImage
+  virtual unsigned long GetMemorySize() const;
+  virtual unsigned long GetTransientMemorySize() const;
+
   double GetDoselVolume(){return mVoxelSize.x()*mVoxelSize.y()*mVoxelSize.z();}
 
   // Retreive the image voxel size (vc)
@@ -92,6 +100,20 @@ public :
                                        const G4ThreeVector mPosition,
                                        const StepHitType mStepHitType);
 
+  /// Pre and post step positions in the frame of the volume, false if the step is not in the volume
+  static bool GetStepPositionsInVolume(const GateVVolume *,
+                                       const G4Step  * step,
+                                       G4ThreeVector & prePosition,
+                                       G4ThreeVector & postPosition);
+
+  static int GetIndexFromStepPositionsInVolume(G4ThreeVector prePosition,
+                                               G4ThreeVector postPosition,
+                                               const GateImage & image,
+                                               const bool mPositionIsSet,
+                                               const G4ThreeVector mPosition,
+                                               const StepHitType mStepHitType,
+                                               const G4double randomPosition);
+
 protected:
 
   //-----------------------------------------------------------------------------
@@ -111,6 +133,12 @@ protected:
   bool           mResolutionIsSet;
   bool           mHalfSizeIsSet;
   bool           mPositionIsSet;
+  bool           mIsSinglePrecisionTempImageEnabled;
+  bool           mIsSparseImageEnabled;
+
+  // Images of the actor, for the memory report
+  std::vector<GateImageWithStatistic*> mListOfImagesWithStatistic;
+  std::vector<GateVImage*>             mListOfOtherImages;
 
   int GetIndexFromTrackPosition(const GateVVolume *, const G4Track * track);
   int GetIndexFromStepPosition(const GateVVolume *, const G4Step  * step);
@@ -57,6 +57,7 @@ class GateVoxelizedMass
   void    SetMaterialFilter   (G4String);
   void    SetVolumeFilter     (G4String);
   void    SetExternalMassImage(G4String);
+  void    SetMassCacheDirectory(G4String);
 
   pair<double,double> VoxelIteration(const G4VPhysicalVolume*,int, G4RotationMatrix, G4ThreeVector,int index);
 
@@ -70,10 +71,16 @@ class GateVoxelizedMass
 
   void GenerateVectors();
   void GenerateVoxels();
-  void GenerateDosels(int index);
+  void GenerateDosels(int index, std::vector<double> & doselMin, std::vector<double> & doselMax);
+  void GenerateLabelMasses();
+  void GenerateParameterizedVectors();
 
   pair<double,double> ParameterizedVolume(int index);
 
+  G4String GetMassCacheFilename();
+  bool ReadMassCache(G4String filename);
+  void WriteMassCache(G4String filename);
+
   GateVImageVolume* imageVolume;
   const G4VPhysicalVolume* DAPV;
   const G4LogicalVolume* DALV;
@@ -96,10 +103,11 @@ class GateVoxelizedMass
 
   //std::vector<double> doselReconstructedCubicVolume;
   std::vector<double> doselReconstructedMass;
-  std::vector<double> doselMin;
-  std::vector<double> doselMax;
   std::vector<double> doselExternalMass;
 
+  // Label of the image -> (mass of one voxel, accepted by the material filter)
+  std::map<double,std::pair<double,bool> > mLabelMass;
+
   double voxelCubicVolume;
   double mFilteredVolumeMass;
   double mFilteredVolumeCubicVolume;
@@ -111,6 +119,7 @@ class GateVoxelizedMass
   G4String mMassFile;
   G4String mMaterialFilter;
   G4String mVolumeFilter;
+  G4String mMassCacheDirectory;
 
   bool mIsInitialized;
   bool mIsParameterised;
@@ -14,6 +14,9 @@
 #include "GateVActor.hh"
 #include "GateMultiSensitiveDetector.hh"
 
+#include <algorithm>
+#include <sstream>
+
 //-----------------------------------------------------------------------------
 GateActorManager::GateActorManager()
 {
@@ -133,6 +136,7 @@ void GateActorManager::CreateListsOfEnabledActors()
     }
   }
 
+  PrintMemoryReport();
   IsInitialized++;
 }
 //-----------------------------------------------------------------------------
@@ -159,6 +163,30 @@ void GateActorManager::PrintListOfActors() const
 }
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+void GateActorManager::PrintMemoryReport() const
+{
+  // Format in MB without changing the state of the output stream
+  auto MB = [](unsigned long size) {
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(1) << size/(1024.0*1024.0) << " MB";
+    return os.str();
+  };
+  unsigned long total = 0;
+  unsigned long transient = 0;
+  std::vector<GateVActor*>::const_iterator sit;
+  for (sit= theListOfActors.begin(); sit!=theListOfActors.end(); ++sit) {
+    const unsigned long size = (*sit)->GetMemorySize();
+    if (size == 0) continue;
+    GateMessage("Actor", 0, "Memory of actor " << (*sit)->GetObjectName() << ": " << MB(size)
+                << " (+" << MB((*sit)->GetTransientMemorySize()) << " while saving)" << Gateendl);
+    total += size;
+    transient = std::max(transient, (*sit)->GetTransientMemorySize());
+  }
+  if (total > 0)
+    GateMessage("Actor", 0, "Memory of all actors: " << MB(total)
+                << " (+" << MB(transient) << " while saving)" << Gateendl);
+}
 //-----------------------------------------------------------------------------
 std::vector<GateVActor*> GateActorManager::ReturnListOfActors()
 {
@@ -72,6 +72,9 @@ void GateAdder::Digitize()
 	std::vector< GateDigi* >* outputDigiCollectionVector = m_OutputDigiCollection->GetVector ();
 	std::vector<GateDigi*>::iterator iter;
 
+	// output digis are found by the handle of their volumeID (equal handles <=> equal volumeIDs)
+	m_outputDigiIndex.clear();
+
 
   if (IDC)
      {
@@ -86,32 +89,30 @@ void GateAdder::Digitize()
 		  //This part is from ProcessOnePulse
 #ifdef GATE_USE_OPTICAL
 		  // ignore pulses based on optical photons. These can be added using the opticaladder
-		  if (!inputDigi->IsOptical())
+		  if (inputDigi->IsOptical())
+			  continue;
 #endif
-		     for (iter=outputDigiCollectionVector->begin(); iter!= outputDigiCollectionVector->end() ; ++iter)
+		     std::unordered_map<G4int, size_t>::const_iterator found = m_outputDigiIndex.find(inputDigi->GetVolumeIDHandle());
+
+		     if (found != m_outputDigiIndex.end())
 		     {
-		    	 if ( (*iter)->GetVolumeID()   == inputDigi->GetVolumeID() )
-		    	 {
-		    		 if(m_positionPolicy==kEnergyWinner){
-		    			 m_outputDigi = MergePositionEnergyWin(inputDigi,*iter);
-		    		 }
-		    		 else{
-		    			 m_outputDigi = CentroidMerge( inputDigi,*iter );
-		    		 }
-
-		    		 if (nVerboseLevel>1)
-		    		 	 {
-		    			 	 G4cout << " [GateAdder::Digitize] Merged previous digi for volume " << inputDigi->GetVolumeID()
-		 						 << " with new digi of energy " << G4BestUnit(inputDigi->GetEnergy(),"Energy") <<".\n"
-								 << "Resulting digi is: \n"
-								 << **iter << Gateendl << Gateendl ;
-		    		 	 }
-		    		 break;
+		    	 GateDigi* sameVolumeDigi = (*outputDigiCollectionVector)[found->second];
+		    	 if(m_positionPolicy==kEnergyWinner){
+		    		 m_outputDigi = MergePositionEnergyWin(inputDigi,sameVolumeDigi);
+		    	 }
+		    	 else{
+		    		 m_outputDigi = CentroidMerge( inputDigi,sameVolumeDigi );
 		    	 }
 
-		     }//loop over iter
-
-		     if ( iter == outputDigiCollectionVector->end() )
+		    	 if (nVerboseLevel>1)
+		    	 {
+		    		 G4cout << " [GateAdder::Digitize] Merged previous digi for volume " << inputDigi->GetVolumeID()
+		    				 << " with new digi of energy " << G4BestUnit(inputDigi->GetEnergy(),"Energy") <<".\n"
+							 << "Resulting digi is: \n"
+							 << *sameVolumeDigi << Gateendl << Gateendl ;
+		    	 }
+		     }
+		     else
 		     {
 		    	 m_outputDigi = new GateDigi(*inputDigi);
 		    	 m_outputDigi->SetEnergyIniTrack(-1);
@@ -120,6 +121,7 @@ void GateAdder::Digitize()
 		    		 G4cout << "[GateAdder::Digitize] Created new digi for volume " << inputDigi->GetVolumeID() << ".\n"
 					 << "Resulting digi is: \n"
 					 << *m_outputDigi << Gateendl << Gateendl ;
+		    	 m_outputDigiIndex[inputDigi->GetVolumeIDHandle()] = outputDigiCollectionVector->size();
 		    	 m_OutputDigiCollection->insert(m_outputDigi);
 		     }
 
@@ -142,6 +144,43 @@ void GateAdder::Digitize()
 }
 
 
+// Same merging as Digitize(): the first digi of each volume is kept and receives the
+// following digis of the same volume, which are then deleted
+void GateAdder::DigitizeInPlace(std::vector<GateDigi*>& digis)
+{
+	m_outputDigiIndex.clear();
+	std::vector<G4bool> keep(digis.size(), false);
+
+	for (size_t i=0; i<digis.size(); i++)
+	{
+		GateDigi* inputDigi = digis[i];
+#ifdef GATE_USE_OPTICAL
+		// ignore pulses based on optical photons. These can be added using the opticaladder
+		if (inputDigi->IsOptical())
+			continue;
+#endif
+		std::unordered_map<G4int, size_t>::const_iterator found = m_outputDigiIndex.find(inputDigi->GetVolumeIDHandle());
+
+		if (found != m_outputDigiIndex.end())
+		{
+			if(m_positionPolicy==kEnergyWinner)
+				MergePositionEnergyWin(inputDigi, digis[found->second]);
+			else
+				CentroidMerge(inputDigi, digis[found->second]);
+		}
+		else
+		{
+			inputDigi->SetEnergyIniTrack(-1);
+			inputDigi->SetEnergyFin(-1);
+			m_outputDigiIndex[inputDigi->GetVolumeIDHandle()] = i;
+			keep[i] = true;
+		}
+	}
+
+	RemoveRejectedDigis(digis, keep);
+}
+
+
 void GateAdder::SetPositionPolicy(const G4String &policy)
 {
 	if (policy=="takeEnergyWinner")
@@ -210,14 +210,14 @@ GateDigi* GateAdderCompton::CentroidMergeCompton(GateDigi *right, GateDigi *outp
     if ( right->m_nPhantomCompton > output->m_nPhantomCompton )
     {
     	output->m_nPhantomCompton 	= right->m_nPhantomCompton;
-    	output->m_comptonVolumeName = right->m_comptonVolumeName;
+    	output->m_comptonVolumeNameHandle = right->m_comptonVolumeNameHandle;
     }
 
     // # of Rayleigh process: store the max nb
     if ( right->m_nPhantomRayleigh > output->m_nPhantomRayleigh )
     {
     	output->m_nPhantomRayleigh 	= right->m_nPhantomRayleigh;
-    	output->m_RayleighVolumeName = right->m_RayleighVolumeName;
+    	output->m_RayleighVolumeNameHandle = right->m_RayleighVolumeNameHandle;
     }
 
     // HDS : # of septal hits: store the max nb
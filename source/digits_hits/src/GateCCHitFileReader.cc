@@ -10,6 +10,7 @@
 
 #ifdef G4ANALYSIS_USE_ROOT
 
+#include <algorithm>
 #include <TBranch.h>
 #include "GateHit.hh"
 #include "GateOutputVolumeID.hh"
@@ -30,6 +31,7 @@ GateCCHitFileReader::GateCCHitFileReader(G4String file)
   , m_hitTree(0)
   , m_entries(0)
   , m_currentEntry(0)
+  , m_cacheSize(100*1024*1024)
 {
 
 
@@ -110,6 +112,11 @@ void GateCCHitFileReader::PrepareAcquisition()
   // Set the addresses of the branch buffers: each buffer is a field of the root-hit structure
   GateCCHitTree::SetBranchAddresses(m_hitTree,m_hitBuffer);
 
+  // All the branches are read: they are put in the cache from the start (no learning phase)
+  m_hitTree->SetCacheSize(m_cacheSize);
+  m_hitTree->AddBranchToCache("*",kTRUE);
+  m_hitTree->StopCacheLearningPhase();
+
 
   //Load the first hit into the root-hit structure
   LoadHitData();
@@ -201,15 +208,45 @@ void GateCCHitFileReader::TerminateAfterAcquisition()
 }
 
 
+// The hit buffer holds the first hit of the next event, or the end-of-file indicators
 G4bool GateCCHitFileReader::HasNextEvent(){
 
-  if (m_currentEntry>=m_entries){
+  return !( (m_hitBuffer.eventID==-1) && (m_hitBuffer.runID==-1) );
+}
 
-    return false;
-  }
-  else{
-    return true;
+
+G4long GateCCHitFileReader::FindEventStart(G4long entry)
+{
+  if (entry<=0)
+    return 0;
+  if (entry>=m_entries)
+    return (G4long)m_entries;
+
+  TBranch* eventBranch = m_hitTree->GetBranch("eventID");
+  TBranch* runBranch = m_hitTree->GetBranch("runID");
+
+  eventBranch->GetEntry(entry-1);
+  runBranch->GetEntry(entry-1);
+  G4int eventID = m_hitBuffer.eventID;
+  G4int runID = m_hitBuffer.runID;
+
+  for ( ; entry<m_entries ; ++entry) {
+    eventBranch->GetEntry(entry);
+    runBranch->GetEntry(entry);
+    if ( (m_hitBuffer.eventID!=eventID) || (m_hitBuffer.runID!=runID) )
+      break;
   }
+  return entry;
+}
+
+
+void GateCCHitFileReader::SelectEntries(G4long first, G4long end)
+{
+  m_currentEntry = first;
+  m_entries = std::min(end, (G4long)m_hitTree->GetEntries());
+  m_hitTree->SetCacheEntryRange(first, m_entries);
+
+  LoadHitData();
 }
 
 // Reads a set of hit data from the hit-tree, and stores them into the root-hit buffer
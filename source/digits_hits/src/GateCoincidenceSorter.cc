@@ -8,6 +8,8 @@ See LICENSE.md for further details
 
 #include "GateCoincidenceSorter.hh"
 
+#include <algorithm>
+
 #include "Randomize.hh"
 
 #include "G4UnitsTable.hh"
@@ -45,7 +47,10 @@ GateCoincidenceSorter::GateCoincidenceSorter(GateDigitizerMgr* itsDigitizerMgr,
     m_allDigiOpenCoincGate(false),
     m_depth(1),
     m_presortBufferSize(256),
+    m_presortCounter(0),
     m_presortWarning(false),
+    m_inputDigitizer(0),
+    m_sortingLeader(0),
     m_CCSorter(IsCCSorter),
     m_triggerOnlyByAbsorber(0),
     m_eventIDCoinc(0)
@@ -75,11 +80,9 @@ GateCoincidenceSorter::GateCoincidenceSorter(GateDigitizerMgr* itsDigitizerMgr,
 // Destructor
 GateCoincidenceSorter::~GateCoincidenceSorter()
 {
-  while(m_presortBuffer.size() > 0)
-  {
-    delete m_presortBuffer.back();
-    m_presortBuffer.pop_back();
-  }
+  for (size_t i=0; i<m_presortBuffer.size(); ++i)
+    delete m_presortBuffer[i].digi;
+  m_presortBuffer.clear();
 
   while(m_coincidenceDigis.size() > 0)
   {
@@ -167,31 +170,17 @@ void GateCoincidenceSorter::Digitize()
 		
 
 		
-  GateDigi* digi;
-  std::list<GateDigi*>::iterator buf_iter;                // presort buffer iterator
-
-  std::deque<GateCoincidenceDigi*>::iterator coince_iter; // coincidence list iterator
+  // the digis are sorted and dispatched by the leader (see ProcessSortedDigi())
+  if (m_sortingLeader)
+    return;
 
-  G4bool inCoincidence;
+  GateDigi* digi;
 
   GateCoincidenceDigi* coincidence;
   G4double window, offset;
 
   //Input digi collection
-  GateDigitizerMgr* digitizerMgr = GateDigitizerMgr::GetInstance();
-  GateSinglesDigitizer* inputDigitizer;
-
-  inputDigitizer = digitizerMgr->FindSinglesDigitizer(m_inputName);//m_collectionName);
-  //G4cout<<"m_inputName "<<inputDigitizer->GetName()<<G4endl;
-  if (!inputDigitizer)
-	  if (digitizerMgr->m_SDlist.size()==1)
-  	  {
-		  G4String new_name= m_inputName+"_"+digitizerMgr->m_SDlist[0]->GetName();
-		  //G4cout<<" new_name "<< new_name<<G4endl;
-		  inputDigitizer = digitizerMgr->FindSinglesDigitizer(new_name);
-  	  }
-	  else
-		  GateError("ERROR: The name _"+ m_inputName+"_ is unknown for input singles digicollection! \n");
+  GateSinglesDigitizer* inputDigitizer = GetInputDigitizer();
 
   if(!m_system)
     {
@@ -216,8 +205,20 @@ void GateCoincidenceSorter::Digitize()
   //Output digi collection
   m_OutputCoincidenceDigiCollection = new GateCoincidenceDigiCollection("GateCoincidenceSorter",m_outputName); // to create the Digi Collection
 
+  for (size_t f=0; f<m_sortingFollowers.size(); f++)
+  {
+    GateCoincidenceSorter* follower = m_sortingFollowers[f];
+    if (follower->GetInputName() != m_inputName)
+      GateError("***ERROR*** CoincidenceSorter " << follower->GetOutputName() << " shares the sorting of " << m_outputName
+                << " but their input collections differ (" << follower->GetInputName() << ", " << m_inputName << ")\n");
+    if (follower->m_eventIDCoinc || m_eventIDCoinc)
+      GateError("***ERROR*** CoincidenceSorter " << follower->GetOutputName() << ": setEventIDCoinc can not be used with a shared sorting\n");
+    if (!follower->m_system)
+      follower->m_system = m_system;
+    follower->m_OutputCoincidenceDigiCollection = new GateCoincidenceDigiCollection("GateCoincidenceSorter",follower->m_outputName);
+  }
 
-  if (!IsEnabled())
+  if (!IsEnabled() && m_sortingFollowers.empty())
      return;
 
 
@@ -267,108 +268,151 @@ void GateCoincidenceSorter::Digitize()
 
 
   //------ put input digis in sorted input buffer----------
+  // The buffer is a binary heap with the earliest digi on top: insertion and
+  // removal are O(log n) whatever the buffer size.
   for(gpl_iter = IDCvector->begin();gpl_iter != IDCvector->end();gpl_iter++)
   {
-      // make a copy of the digi
+      // make a copy of the digi (the input collection keeps ownership of its digis)
       digi = new GateDigi(**gpl_iter);
 
-      if(m_presortBuffer.empty())
-    	  m_presortBuffer.push_back(digi);
-      else if(digi->GetTime() < m_presortBuffer.back()->GetTime())    // check that even isn't earlier than the earliest event in the buffer
+      // check that even isn't earlier than the earliest event in the buffer
+      if(!m_presortBuffer.empty() && digi->GetTime() < m_presortBuffer.front().time)
       {
           if(!m_presortWarning)
               GateWarning("Event is earlier than earliest event in coincidence presort buffer. Consider using a larger buffer (/setPresortBufferSize n, where n>256)");
-          m_presortWarning = true;
-          m_presortBuffer.push_back(digi); // this will probably not cause a problem, but coincidences may be missed
+          m_presortWarning = true; // this will probably not cause a problem, but coincidences may be missed
       }
-      else // put the event into the presort buffer in the right place
-      {
-          buf_iter = m_presortBuffer.begin();
-          while(digi->GetTime() < (*buf_iter)->GetTime())
-              buf_iter++;
-          m_presortBuffer.insert(buf_iter, digi);
-          // G4cout<<"presortBuffer filled in position "<<std::distance(m_presortBuffer.begin(),buf_iter)<<G4endl;
-          // G4cout<<"digiTime "<<digi->GetTime()<<G4endl;
-          // G4cout<<"digiTime "<<digi->GetTime()/ns<<G4endl;
-      }
-
+      PresortEntry entry = { digi->GetTime(), m_presortCounter++, digi };
+      m_presortBuffer.push_back(entry);
+      std::push_heap(m_presortBuffer.begin(), m_presortBuffer.end());
   }
 
 
   //  once buffer reaches the specified size look for coincidences
   for(G4int i = m_presortBuffer.size();i > m_presortBufferSize;i--)
   {
-    digi = m_presortBuffer.back();
+    std::pop_heap(m_presortBuffer.begin(), m_presortBuffer.end());
+    digi = m_presortBuffer.back().digi;
     m_presortBuffer.pop_back();
-    // process completed coincidence pulse window at front of list
-    while(!m_coincidenceDigis.empty() && m_coincidenceDigis.front()->IsAfterWindow(digi))
-    {
-    	coincidence = m_coincidenceDigis.front();
 
-    	m_coincidenceDigis.pop_front();
+    // the followers copy what they keep, this sorter keeps the digi itself
+    for (size_t f=0; f<m_sortingFollowers.size(); f++)
+      if (m_sortingFollowers[f]->IsEnabled())
+        m_sortingFollowers[f]->ProcessSortedDigi(digi, false);
 
-        if(m_CCSorter==true){
-        //TODO CC sorter
-           // ProcessCompletedCoincidenceWindow4CC(coincidence);
-        }
-        else{
-            ProcessCompletedCoincidenceWindow(coincidence);
-        }
+    if (IsEnabled())
+      ProcessSortedDigi(digi, true);
+    else
+      delete digi;
+  }
 
-   }
-    // add event to coincidences
-    inCoincidence = false;
-    coince_iter = m_coincidenceDigis.begin();
-    while( coince_iter != m_coincidenceDigis.end() && (*coince_iter)->IsInCoincidence(digi) )
-    {
-      inCoincidence = true;
-       //AE here fill coincidence
-      (*coince_iter)->push_back(new GateDigi(digi)); // add a copy so we can delete safely
-      coince_iter++;
-    }
+  for (size_t f=0; f<m_sortingFollowers.size(); f++)
+    m_sortingFollowers[f]->StoreDigiCollection(m_sortingFollowers[f]->m_OutputCoincidenceDigiCollection);
 
-    // if not after or in the windows, it must be before the rest of coincidence windows
-    // so there's no need to check the rest of the coincidence list
+  if (!IsEnabled())
+  {
+    delete m_OutputCoincidenceDigiCollection;
+    return;
+  }
+  StoreDigiCollection(m_OutputCoincidenceDigiCollection);
 
-    // update coincidence digi list
-        if(m_allDigiOpenCoincGate || !inCoincidence)
-        {
-          if(m_coincidenceWindowJitter > 0.0)
-            window = G4RandGauss::shoot(m_coincidenceWindow,m_coincidenceWindowJitter);
-          else
-            window = m_coincidenceWindow;
 
-          if(m_offsetJitter > 0.0)
-            offset = G4RandGauss::shoot(m_offset,m_offsetJitter);
-          else
-            offset = m_offset;
 
-          if(m_triggerOnlyByAbsorber==1){
 
-              if(((digi->GetVolumeID()).GetBottomCreator())->GetObjectName()==m_absorberSD){
-              //if(digi->GetVolumeID().GetVolume(2)->GetName()==m_absorberDepth2Name){
-                  coincidence = new GateCoincidenceDigi(digi,window,offset);
-                   //AE here open coincidence
-                   m_coincidenceDigis.push_back(coincidence);
+}
 
-              }
-          }
-          else{
-            coincidence = new GateCoincidenceDigi(digi,window,offset);
-             //AE here open window with the digi
-             m_coincidenceDigis.push_back(coincidence);
-          }
-        }
-        else
-          delete digi; // digis that don't open a coincidence window can be discarded
-  }
 
-  StoreDigiCollection(m_OutputCoincidenceDigiCollection);
+//------------------------------------------------------------------------------------------------------
+// A digi leaving the presort buffer: completed windows are processed, then the digi is
+// added to the open windows and may open a new one. A digi that is not owned (stream
+// shared with other sorters) is only copied.
+void GateCoincidenceSorter::ProcessSortedDigi(GateDigi* digi, G4bool ownsDigi)
+{
+  std::deque<GateCoincidenceDigi*>::iterator coince_iter; // coincidence list iterator
+  std::deque<GateCoincidenceDigi*>::iterator coince_end;  // first window not in coincidence
 
+  G4bool inCoincidence;
 
+  GateCoincidenceDigi* coincidence;
+  G4double window, offset;
 
+   // process completed coincidence pulse window at front of list
+   while(!m_coincidenceDigis.empty() && m_coincidenceDigis.front()->IsAfterWindow(digi))
+   {
+   	coincidence = m_coincidenceDigis.front();
+
+   	m_coincidenceDigis.pop_front();
+
+       if(m_CCSorter==true){
+       //TODO CC sorter
+          // ProcessCompletedCoincidenceWindow4CC(coincidence);
+       }
+       else{
+           ProcessCompletedCoincidenceWindow(coincidence);
+       }
+
+  }
+   // find the open windows the event belongs to
+   coince_end = m_coincidenceDigis.begin();
+   while( coince_end != m_coincidenceDigis.end() && (*coince_end)->IsInCoincidence(digi) )
+     coince_end++;
+   inCoincidence = (coince_end != m_coincidenceDigis.begin());
+
+   // if not after or in the windows, it must be before the rest of coincidence windows
+   // so there's no need to check the rest of the coincidence list
+
+   // does the event open a new window?
+   G4bool opensWindow = false;
+   if(m_allDigiOpenCoincGate || !inCoincidence)
+   {
+     if(m_coincidenceWindowJitter > 0.0)
+       window = G4RandGauss::shoot(m_coincidenceWindow,m_coincidenceWindowJitter);
+     else
+       window = m_coincidenceWindow;
+
+     if(m_offsetJitter > 0.0)
+       offset = G4RandGauss::shoot(m_offset,m_offsetJitter);
+     else
+       offset = m_offset;
+
+     opensWindow = (m_triggerOnlyByAbsorber!=1)
+       || (((digi->GetVolumeID()).GetBottomCreator())->GetObjectName()==m_absorberSD);
+   }
+
+   // add event to coincidences: each window gets a copy, except the last one
+   // which takes the digi itself when it does not open a window
+   for(coince_iter = m_coincidenceDigis.begin(); coince_iter != coince_end; coince_iter++)
+   {
+     //AE here fill coincidence
+     if(ownsDigi && !opensWindow && coince_iter+1 == coince_end)
+       (*coince_iter)->push_back(digi);
+     else
+       (*coince_iter)->push_back(new GateDigi(digi));
+   }
 
+   // update coincidence digi list
+   if(opensWindow)
+   {
+     //AE here open window with the digi
+     coincidence = new GateCoincidenceDigi(ownsDigi ? digi : new GateDigi(digi),window,offset);
+     m_coincidenceDigis.push_back(coincidence);
+   }
+   else if(ownsDigi && !inCoincidence)
+     delete digi; // digis that don't open a coincidence window can be discarded
 }
+//------------------------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------------------------
+void GateCoincidenceSorter::SetSortingLeader(GateCoincidenceSorter* leader)
+{
+  if (leader == this || leader->m_sortingLeader || !m_sortingFollowers.empty())
+    GateError("***ERROR*** CoincidenceSorter " << m_outputName << " can not share the sorting of " << leader->GetOutputName()
+              << ": a sorter is either the leader or a follower of one leader\n");
+  m_sortingLeader = leader;
+  leader->m_sortingFollowers.push_back(this);
+}
+//------------------------------------------------------------------------------------------------------
 
 /*
 void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow4CC(GateCoincidenceDigi *coincidence)
@@ -758,6 +802,31 @@ G4bool GateCoincidenceSorter::IsForbiddenCoincidence(const GateDigi* digi1, cons
 //------------------------------------------------------------------------------------------------------
 // Next method was added for the multi-system approach
 
+//------------------------------------------------------------------------------------------------------
+// The input digitizer does not change during the run: it is looked up on the
+// first event only (the digitizers are not all built when the sorter is created)
+GateSinglesDigitizer* GateCoincidenceSorter::GetInputDigitizer()
+{
+  if (m_inputDigitizer)
+    return m_inputDigitizer;
+
+  GateDigitizerMgr* digitizerMgr = GateDigitizerMgr::GetInstance();
+  m_inputDigitizer = digitizerMgr->FindSinglesDigitizer(m_inputName);
+  if (!m_inputDigitizer)
+  {
+	  if (digitizerMgr->m_SDlist.size()==1)
+	  {
+		  G4String new_name= m_inputName+"_"+digitizerMgr->m_SDlist[0]->GetName();
+		  m_inputDigitizer = digitizerMgr->FindSinglesDigitizer(new_name);
+	  }
+	  if (!m_inputDigitizer)
+		  GateError("ERROR: The name _"+ m_inputName+"_ is unknown for input singles digicollection! \n");
+  }
+  return m_inputDigitizer;
+}
+//------------------------------------------------------------------------------------------------------
+
+
 void GateCoincidenceSorter::SetSystem(G4String& inputName)
 {
    for (size_t i=0; i<m_digitizerMgr->m_SingleDigitizersList.size() ; ++i)
@@ -99,6 +99,12 @@ GateCoincidenceSorterMessenger::GateCoincidenceSorterMessenger(GateCoincidenceSo
   SetEventIDCoincCmd = new G4UIcmdWithABool(cmdName,this);
   SetEventIDCoincCmd->SetGuidance("Set to one for event identification coincidencences");
 
+  cmdName = GetDirectoryName()+"shareSortingWith";
+  ShareSortingWithCmd = new G4UIcmdWithAString(cmdName,this);
+  ShareSortingWithCmd->SetGuidance("Use the presort buffer of another coincidence sorter reading the same singles");
+  ShareSortingWithCmd->SetGuidance("(the digis are sorted once and feed the windows of both sorters)");
+  ShareSortingWithCmd->SetParameterName("Name",false);
+
 
 }
 
@@ -118,6 +124,7 @@ GateCoincidenceSorterMessenger::~GateCoincidenceSorterMessenger()
     delete SetAcceptancePolicy4CCCmd;
     delete SetEventIDCoincCmd;
     delete forceMinSectorDiffCmd;
+    delete ShareSortingWithCmd;
 }
 
 
@@ -162,6 +169,13 @@ void GateCoincidenceSorterMessenger::SetNewValue(G4UIcommand* aCommand, G4String
 	    	m_CoincidenceSorter->SetSystem(newValue); //! Attach to the suitable system from the digitizer m_systemList (multi-system approach)
 	    }
 	  }
+  else if (aCommand == ShareSortingWithCmd)
+    {
+      GateCoincidenceSorter* leader = GateDigitizerMgr::GetInstance()->FindCoincidenceSorter(newValue);
+      if (!leader)
+        GateError("ERROR: The name _"+ newValue+"_ is unknown for a coincidence sorter! \n");
+      m_CoincidenceSorter->SetSortingLeader(leader);
+    }
   else if (aCommand == MultiplePolicyCmd)
     { m_CoincidenceSorter->SetMultiplesPolicy(newValue); }
   else if (aCommand == SetAcceptancePolicy4CCCmd)
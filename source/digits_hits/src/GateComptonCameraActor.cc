@@ -42,6 +42,7 @@ GateComptonCameraActor::GateComptonCameraActor(G4String name, G4int depth):
 
     Ei = 0.;
     Ef = 0.;
+    VolIndexStep = -1;
     newEvt = true;
     newTrack = true;
     edepEvt = 0.;
@@ -170,6 +171,9 @@ void GateComptonCameraActor::Construct()
         }
 
     }
+    mStepVolumeIndex.clear();
+    mStepVolumeNames.clear();
+    mStepVolumeIsLayer.clear();
 
 
     //To select primary particles for example in ion sources. Otherwise the associated to the primary particle is set to the particle with parentID=0
@@ -804,7 +808,6 @@ void GateComptonCameraActor::UserSteppingAction(const GateVVolume *  , const G4S
     trackLength  = aTrack->GetTrackLength();
     trackLocalTime = aTrack->GetLocalTime();
 
-    G4String partName = aTrack->GetDefinition()->GetParticleName();
     G4int  PDGEncoding= aTrack->GetDefinition()->GetPDGEncoding();
 
     //============info of current step ======================================
@@ -812,32 +815,14 @@ void GateComptonCameraActor::UserSteppingAction(const GateVVolume *  , const G4S
     hitPrePos = step->GetPreStepPoint()->GetPosition()/mm;
     hitEdep=step->GetTotalEnergyDeposit()/MeV;
 
-    //Volume name od the step tosave only the hits in SD of the layers
-    G4TouchableHandle touchable=step->GetPreStepPoint()->GetTouchableHandle();
-    int copyNumberStep=touchable->GetVolume(0)->GetCopyNo();
-    G4String nameCurrentV=touchable->GetVolume(0)->GetName();
-    unsigned extPos=nameCurrentV.rfind("_phys");
-    nameCurrentV=nameCurrentV.substr(0,extPos);
-    //VolNameStep=nameCurrentV;
-    if(copyNumberStep!=0 && nameCurrentV!=mNameOfAbsorberSDVol){
-        VolNameStep=nameCurrentV+std::to_string(copyNumberStep);
-    }
-    else{
-
-        VolNameStep=nameCurrentV;
-    }
-
-    //G4cout<<VolNameStep<<G4endl;
+    //Volume of the step to save only the hits in SD of the layers
     const G4TouchableHistory*  touchableH = (const G4TouchableHistory*)(step->GetPreStepPoint()->GetTouchable() );
-    GateVolumeID volumeID(touchableH);
+    VolIndexStep=GetStepVolumeIndex(touchableH->GetVolume(0));
 
-    hitPreLocalPos=volumeID.MoveToBottomVolumeFrame(hitPrePos);
-    hitPostLocalPos=volumeID.MoveToBottomVolumeFrame(hitPostPos);
-    G4ThreeVector hitMeanLocalPos=(hitPreLocalPos+hitPostLocalPos)/2;
-    // std::cout << "VolumNameStep " <<VolNameStep <<"energy="<<hitEdep<<'\n';
     //========================track (step) =========================================
+    static const G4String noProcessName;
     const G4VProcess* processTrack = aTrack->GetCreatorProcess();
-    G4String processName = ( (processTrack != NULL) ? processTrack->GetProcessName() : G4String() ) ;
+    const G4String& processName = ( (processTrack != NULL) ? processTrack->GetProcessName() : noProcessName ) ;
     if(step->GetPostStepPoint()->GetProcessDefinedStep()!=0){
         processPostStep=step->GetPostStepPoint()->GetProcessDefinedStep()->GetProcessName();
     }
@@ -887,16 +872,22 @@ void GateComptonCameraActor::UserSteppingAction(const GateVVolume *  , const G4S
     }
 
 
-    std::vector<G4String>::iterator it= find (layerNames.begin(), layerNames.end(), VolNameStep);
-    if (it != layerNames.end()){
+    if (mStepVolumeIsLayer[VolIndexStep]){
         //Hits with preStep in sensitive volumes.
 
+        //The volumeID is only needed for the hits in the layers
+        GateVolumeIDTable* volumeIDTable = GateVolumeIDTable::GetInstance();
+        const G4int volumeIDHandle = volumeIDTable->GetVolumeIDHandle(touchableH);
+        const GateVolumeID& volumeID = volumeIDTable->GetVolumeID(volumeIDHandle);
+        hitPreLocalPos=volumeID.MoveToBottomVolumeFrame(hitPrePos);
+        hitPostLocalPos=volumeID.MoveToBottomVolumeFrame(hitPostPos);
+
         // step ends in the  boundary and it is an electron. Here is the case in which the pre-step is in a sensitive volume
         if(step->GetPostStepPoint()->GetStepStatus() == fGeomBoundary && PDGEncoding==11){
             //This is an electron  with a preStep in sensitive volumes and the post-step in the boundary (escaping from the SD)
             energyElectronEscapedEvt=Ef/MeV;
             IseExitingSDVol=true;
-            eEspVolName=VolNameStep;
+            eEspVolName=mStepVolumeNames[VolIndexStep];
             //Fill file each time that an electron exits a SD volume. There can be several entries per event.
             mFileEvent.fill();
 
@@ -1003,7 +994,7 @@ void GateComptonCameraActor::UserSteppingAction(const GateVVolume *  , const G4S
         aHit->SetParentID(parentID );
         aHit->SetTrackLength(trackLength );
         aHit->SetTrackLocalTime(trackLocalTime );
-        aHit->SetVolumeID(volumeID);
+        aHit->SetVolumeIDHandle(volumeIDHandle);
         aHit->SetEventID(evtID);
         aHit->SetRunID(runID);
         aHit->SetPDGEncoding(PDGEncoding);
@@ -1020,7 +1011,7 @@ void GateComptonCameraActor::UserSteppingAction(const GateVVolume *  , const G4S
         if(hitEdep!=0. ||(parentID==0 && processPostStep!="Transportation")){
             hitsList.push_back(aHit);
             if(mSaveHitsTreeFlag){
-                m_HitsBuffer.Fill(aHit,VolNameStep);
+                m_HitsBuffer.Fill(aHit,mStepVolumeNames[VolIndexStep]);
                 // m_hitsBuffer.Fill(aHit.get(),VolNameStep);
                 mFileHits.fill();
                 m_HitsBuffer.Clear();
@@ -1046,22 +1037,11 @@ void GateComptonCameraActor::UserSteppingAction(const GateVVolume *  , const G4S
             energyElectronEscapedEvt=Ef/MeV;
             IseExitingSDVol=false;
 
-           // eEspVolName=
-            G4TouchableHandle touchable_pos=step->GetPostStepPoint()->GetTouchableHandle();
-            G4String vName=touchable_pos->GetVolume(0)->GetName();
-            unsigned extPos=vName.rfind("_phys");
-            vName=vName.substr(0,extPos);
-            int nCp_pos=touchable_pos->GetVolume(0)->GetCopyNo();
-            if(nCp_pos>0 && vName!=mNameOfAbsorberSDVol){
-
-                vName=vName+std::to_string(nCp_pos);
-                //G4cout<<"!!"<<vName<<G4endl;
-            }
-            eEspVolName=vName;
+            G4int volIndexPost=GetStepVolumeIndex(step->GetPostStepPoint()->GetTouchable()->GetVolume(0));
+            eEspVolName=mStepVolumeNames[volIndexPost];
 
             //If the post step volume is a SD: store info of electron entering a SD
-            std::vector<G4String>::iterator it= find (layerNames.begin(), layerNames.end(), eEspVolName);
-            if (it != layerNames.end()){
+            if (mStepVolumeIsLayer[volIndexPost]){
                //Fill file each time that an electron enters a SD volume.
                 mFileEvent.fill();
             }
@@ -1075,6 +1055,30 @@ void GateComptonCameraActor::UserSteppingAction(const GateVVolume *  , const G4S
 
 
 
+//-----------------------------------------------------------------------------
+G4int GateComptonCameraActor::GetStepVolumeIndex(const G4VPhysicalVolume* volume)
+{
+    const G4int copyNumber=volume->GetCopyNo();
+    std::pair<const G4VPhysicalVolume*,G4int> key(volume,copyNumber);
+    std::map<std::pair<const G4VPhysicalVolume*,G4int>,G4int>::const_iterator iter=mStepVolumeIndex.find(key);
+    if(iter!=mStepVolumeIndex.end())
+        return iter->second;
+
+    //First step in this volume: name it as the layers are named
+    G4String name=volume->GetName();
+    name=name.substr(0,name.rfind("_phys"));
+    if(copyNumber!=0 && name!=mNameOfAbsorberSDVol){
+        name=name+std::to_string(copyNumber);
+    }
+    G4int index=mStepVolumeNames.size();
+    mStepVolumeNames.push_back(name);
+    mStepVolumeIsLayer.push_back(find(layerNames.begin(), layerNames.end(), name)!=layerNames.end());
+    mStepVolumeIndex.insert(std::make_pair(key,index));
+    return index;
+}
+//-----------------------------------------------------------------------------
+
+
 //---------------------------------------------------
 void GateComptonCameraActor::readPulses(GatePulseList* pPulseList)
 {
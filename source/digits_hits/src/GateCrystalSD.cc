@@ -36,6 +36,7 @@
 
 #include "GateRunManager.hh"
 #include "GateObjectStore.hh"
+#include "GateVolumeIDTable.hh"
 #include "GateEmittedGammaInformation.hh"
 
 #include "GateOutputMgr.hh"
@@ -137,7 +138,6 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
   G4double trackLength  = aTrack->GetTrackLength();
   G4double trackLocalTime = aTrack->GetLocalTime();
 
-  G4String partName     = aTrack->GetDefinition()->GetParticleName();
   G4int    PDGEncoding  = aTrack->GetDefinition()->GetPDGEncoding();
 
   //Get information about gamma ( generated by ExtendedVSource )
@@ -161,19 +161,10 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
       	       *newStepPoint = aStep->GetPostStepPoint();
 
 
-  //  Get the process name
+  //  Get the process name (not copied: the hit only keeps its handle in the GateStringTable)
+  static const G4String noProcess;
   const G4VProcess* process = newStepPoint->GetProcessDefinedStep();
-  G4String processName = ( (process != NULL) ? process->GetProcessName() : G4String() ) ;
-  //========================track (step) =========================================
-  G4String processPostStep;
-  const G4VProcess* processTrack = aTrack->GetCreatorProcess();
-  if(aStep->GetPostStepPoint()->GetProcessDefinedStep()!=0){
-      processPostStep=aStep->GetPostStepPoint()->GetProcessDefinedStep()->GetProcessName();
-  }
-  else{
-      processPostStep="NULL";
-  }
-  //=================================================
+  const G4String& processName = ( (process != NULL) ? process->GetProcessName() : noProcess ) ;
 
 
 
@@ -186,7 +177,10 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
       touchable = (const G4TouchableHistory*)(newStepPoint->GetTouchable() );
 
 
-  GateVolumeID volumeID(touchable);
+  // The volumeID is only built the first time a volume is hit, the hit keeps its handle
+  GateVolumeIDTable* volumeIDTable = GateVolumeIDTable::GetInstance();
+  G4int volumeIDHandle = volumeIDTable->GetVolumeIDHandle(touchable);
+  const GateVolumeID& volumeID = volumeIDTable->GetVolumeID(volumeIDHandle);
 
 
   if (volumeID.IsInvalid())
@@ -284,7 +278,7 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
   aHit->SetTrackLocalTime( trackLocalTime );
   aHit->SetMomentumDir( momentumDirection );
   aHit->SetParentID( parentID );
-  aHit->SetVolumeID( volumeID );
+  aHit->SetVolumeIDHandle( volumeIDHandle );
 
   aHit->SetSourceType( source_type );
   aHit->SetDecayType( decay_type );
@@ -313,7 +307,19 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
 
   if(GateSystemListManager::GetInstance()->GetIsAnySystemDefined())
   {
-  GateVSystem* system = FindSystem(volumeID);
+  // The system and output volumeID of a volume do not change during the simulation
+  if (volumeIDHandle >= (G4int)m_systemOfVolume.size())
+  {
+    m_systemOfVolume.resize(volumeIDHandle+1, 0);
+    m_outputVolumeIDOfVolume.resize(volumeIDHandle+1, 0);
+  }
+  if (!m_systemOfVolume[volumeIDHandle])
+  {
+    m_systemOfVolume[volumeIDHandle] = FindSystem(volumeID);
+    m_outputVolumeIDOfVolume[volumeIDHandle] =
+      volumeIDTable->GetOutputVolumeIDHandle(m_systemOfVolume[volumeIDHandle]->ComputeOutputVolumeID(volumeID));
+  }
+  GateVSystem* system = m_systemOfVolume[volumeIDHandle];
   GateSystemComponent* baseComponent = system->GetBaseComponent();
   G4ThreeVector scannerPos = baseComponent->GetCurrentTranslation();
   G4double scannerRotAngle = 0;
@@ -330,8 +336,7 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
   aHit->SetScannerPos( scannerPos );
   aHit->SetScannerRotAngle( scannerRotAngle );
   aHit->SetSystemID(system->GetItsNumber());
-  GateOutputVolumeID outputVolumeID = system->ComputeOutputVolumeID(aHit->GetVolumeID());
-  aHit->SetOutputVolumeID(outputVolumeID);
+  aHit->SetOutputVolumeIDHandle(m_outputVolumeIDOfVolume[volumeIDHandle]);
 
   }
 
@@ -400,7 +405,7 @@ void GateCrystalSD::AddSystem(GateVSystem* aSystem)
 
 
 //------------------------------------------------------------------------------
-GateVSystem* GateCrystalSD::FindSystem(GateVolumeID volumeID)
+GateVSystem* GateCrystalSD::FindSystem(const GateVolumeID& volumeID)
 {
    // MP Garcia (24/03/2014) Modif to handle imbricated boxes between the SPECThead volume and the world
     //size_t m = volumeID.size();
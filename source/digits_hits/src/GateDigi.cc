@@ -36,9 +36,15 @@ GateDigi::GateDigi(const void* itsMother):
 	  m_max_energy(0),
       m_nPhantomCompton(-1),
       m_nPhantomRayleigh(-1),
+      m_comptonVolumeNameHandle(0),
+      m_RayleighVolumeNameHandle(0),
+      m_volumeIDHandle(0),
+      m_outputVolumeIDHandle(0),
       #ifdef GATE_USE_OPTICAL
       m_optical(false),
       #endif
+      m_postStepProcessHandle(0),
+      m_processCreatorHandle(0),
       m_energyError(0.0),
       m_globalPosError(0.0),
       m_localPosError(0.0),
@@ -75,8 +81,8 @@ std::ostream& operator<<(std::ostream& flux, const GateDigi& digi)
               << "\t\t" << "           -> ( R="   << G4BestUnit(digi.m_globalPos.perp(),"Length")     << ", "
               << "phi="   << digi.m_globalPos.phi()/degree       	      	   << " deg,"
               << "z="     << G4BestUnit(digi.m_globalPos.z(),"Length")     	     	      	<< ")\n"
-              << "\t\t" << "VolumeID      " << digi.m_volumeID      	      	      	      	      	      	               << Gateendl
-              << "\t\t" << "OutputID      " << digi.m_outputVolumeID     	      	      	      	      	      	      	       << Gateendl
+              << "\t\t" << "VolumeID      " << digi.GetVolumeID()   	      	      	      	      	      	               << Gateendl
+              << "\t\t" << "OutputID      " << digi.GetOutputVolumeID()  	      	      	      	      	      	      	       << Gateendl
               << "\t\t" << "#Compton      " << digi.m_nPhantomCompton      	      	      	      	      	      	       << Gateendl
               << "\t\t" << "#Rayleigh     " << digi.m_nPhantomRayleigh      	      	      	      	      	      	       << Gateendl
               << "\t\t" << "scannerPos    [ " << G4BestUnit(digi.m_scannerPos,"Length")        	      	      	      	<< "]\n" << Gateendl
@@ -153,17 +159,21 @@ void GateDigi::ChangeVolumeIDAndOutputVolumeIDValue(size_t depth, G4int copyNo)
     //       So in the outputVolumeID this really corresponds to the crystal.
     //       But in the volumeID, this actually corresponds to the level above.
 
+    // The IDs are shared through the GateVolumeIDTable: work on copies and store them back
+    GateVolumeID volumeID = GetVolumeID();
+    GateOutputVolumeID outputVolumeID = GetOutputVolumeID();
+
     // Get the old crystal_id of the pulse at the crystal level
-    G4int old_crystal_id = m_outputVolumeID[depth];
+    G4int old_crystal_id = outputVolumeID[depth];
     // Get the id of this crystal corresponding to the actual daughter number.
     // (it won't be the same if the level above the crystal has daughters declared before the crystal component)
-    G4int old_crystal_daughter_id = m_volumeID[depth+1].GetDaughterID();
+    G4int old_crystal_daughter_id = volumeID[depth+1].GetDaughterID();
     // The daughter id is thus higher or equal to the crystal id.
     // We can thus deduce the shift to be applied to the given copyNo in parameter
     G4int shift_id = old_crystal_daughter_id - old_crystal_id;
     // Get physical volume above the given depth which corresponds to the crystal depth inside the system.
     // But for the the volumeID, we must add 1 as the world is the first volume in the vector.
-    G4VPhysicalVolume* phys_vol = m_volumeID[depth].GetVolume();
+    G4VPhysicalVolume* phys_vol = volumeID[depth].GetVolume();
     // Get physical volume of the wanted copy
     //phys_vol = phys_vol->GetLogicalVolume()->GetDaughter(copyNo+shift_id);
     //G4cout<<"phys_vol "<< phys_vol->GetName() <<G4endl;
@@ -183,13 +193,15 @@ void GateDigi::ChangeVolumeIDAndOutputVolumeIDValue(size_t depth, G4int copyNo)
 
     GateVolumeSelector* volSelector = new GateVolumeSelector(phys_vol);
     // Copy the content of this selector into the given depth
-    //G4cout<<"m_volumeID size "<< m_volumeID.size()<<G4endl;
+    //G4cout<<"volumeID size "<< volumeID.size()<<G4endl;
     //G4cout<<"depth+1 "<< depth+1<<G4endl;
-    m_volumeID[depth+1] = *volSelector;
+    volumeID[depth+1] = *volSelector;
     // Delete the temporary volume selector
     delete volSelector;
     // Finally change the outputVolumeID accordingly
-    m_outputVolumeID[depth] = copyNo;
+    outputVolumeID[depth] = copyNo;
+    SetVolumeID(volumeID);
+    SetOutputVolumeID(outputVolumeID);
 }
 
 
@@ -89,14 +89,14 @@ void GateDigitizerInitializationModule::Digitize()
     		  Digi->SetLocalPos( (*inHC)[i]->GetLocalPos() );
     		  Digi->SetGlobalPos( (*inHC)[i]->GetGlobalPos() );
     		  Digi->SetPDGEncoding( (*inHC)[i]->GetPDGEncoding() );
-    		  Digi->SetOutputVolumeID( (*inHC)[i]->GetOutputVolumeID() );
+    		  Digi->SetOutputVolumeIDHandle( (*inHC)[i]->GetOutputVolumeIDHandle() );
     		  Digi->SetNPhantomCompton( (*inHC)[i]->GetNPhantomCompton() );
     		  Digi->SetNCrystalCompton( (*inHC)[i]->GetNCrystalCompton() );
     		  Digi->SetNPhantomRayleigh( (*inHC)[i]->GetNPhantomRayleigh() );
     		  Digi->SetNCrystalRayleigh( (*inHC)[i]->GetNCrystalRayleigh() );
     		  Digi->SetComptonVolumeName( (*inHC)[i]->GetComptonVolumeName() );
     		  Digi->SetRayleighVolumeName( (*inHC)[i]->GetRayleighVolumeName() );
-    		  Digi->SetVolumeID( (*inHC)[i]->GetVolumeID() );
+    		  Digi->SetVolumeIDHandle( (*inHC)[i]->GetVolumeIDHandle() );
     		  Digi->SetSystemID( (*inHC)[i]->GetSystemID() );
     		  Digi->SetScannerPos( (*inHC)[i]->GetScannerPos() );
     		  Digi->SetScannerRotAngle( (*inHC)[i]->GetScannerRotAngle() );
@@ -22,12 +22,14 @@
 #include "GateHit.hh"
 #include "GateOutputMgr.hh"
 #include "GateToRoot.hh"
+#include "GateRandomEngine.hh"
 
 
 
 #include "G4SystemOfUnits.hh"
 #include "G4DigiManager.hh"
 #include "G4RunManager.hh"
+#include "CLHEP/Random/Random.h"
 
 #include "GateVDigitizerModule.hh"
 
@@ -53,7 +55,8 @@ GateDigitizerMgr::GateDigitizerMgr()
 	  m_isTheFirstEvent(1),
 	  m_recordSingles(0),
 	  m_recordCoincidences(0),
-	  m_alreadyRun(false)
+	  m_alreadyRun(false),
+	  m_chainRandomStreams(false)
 
 {
 	//	G4cout<<"GateDigitizerMgr:: constructor "<<  nVerboseLevel<<G4endl;
@@ -65,6 +68,12 @@ GateDigitizerMgr::~GateDigitizerMgr()
 {
 
  delete fMessenger;
+ for (size_t i = 0; i<m_singlesDigitizerEngines.size(); i++)
+	 delete m_singlesDigitizerEngines[i];
+ for (size_t i = 0; i<m_coincidenceSorterEngines.size(); i++)
+	 delete m_coincidenceSorterEngines[i];
+ for (size_t i = 0; i<m_coincidenceDigitizerEngines.size(); i++)
+	 delete m_coincidenceDigitizerEngines[i];
 }
 
 void GateDigitizerMgr::Initialize()
@@ -149,6 +158,32 @@ void GateDigitizerMgr::Initialize()
 
 	}
 
+	if (m_chainRandomStreams)
+		InitializeChainRandomStreams();
+}
+
+
+void GateDigitizerMgr::InitializeChainRandomStreams()
+{
+	if (!m_singlesDigitizerEngines.empty() || !m_coincidenceSorterEngines.empty() || !m_coincidenceDigitizerEngines.empty())
+		return;
+
+	// Names are unique within each list, the prefix separates the lists
+	GateRandomEngine* randomEngine = GateRandomEngine::GetInstance();
+
+	for (size_t i_D = 0; i_D<m_SingleDigitizersList.size(); i_D++)
+		m_singlesDigitizerEngines.push_back(randomEngine->CreateStreamEngine("SinglesDigitizer/"+m_SingleDigitizersList[i_D]->GetOutputName()));
+
+	for (size_t i = 0; i<m_CoincidenceSortersList.size(); i++)
+		m_coincidenceSorterEngines.push_back(randomEngine->CreateStreamEngine("CoincidenceSorter/"+m_CoincidenceSortersList[i]->m_coincidenceSorterName));
+
+	for (size_t i_D = 0; i_D<m_CoincidenceDigitizersList.size(); i_D++)
+		m_coincidenceDigitizerEngines.push_back(randomEngine->CreateStreamEngine("CoincidenceDigitizer/"+m_CoincidenceDigitizersList[i_D]->GetName()));
+
+	if (nVerboseLevel>0)
+		G4cout << "[GateDigitizerMgr::InitializeChainRandomStreams]: "
+			   << m_singlesDigitizerEngines.size()+m_coincidenceSorterEngines.size()+m_coincidenceDigitizerEngines.size()
+			   << " random streams created\n";
 }
 
 /*
@@ -438,10 +473,19 @@ void GateDigitizerMgr::RunDigitizers()
 	   G4cout << "[GateDigitizerMgr::RunDigitizers]: launching SingleDigitizers. N = " << m_SingleDigitizersList.size() << "\n";
 	   //loops over all digitizers/collections
 	   	//collID get from G4DigiManager
+		CLHEP::HepRandomEngine* mainEngine = CLHEP::HepRandom::getTheEngine();
 		for (size_t i_D = 0; i_D<m_SingleDigitizersList.size(); i_D++)
 		{
 			if (nVerboseLevel>1)
 				G4cout << "[GateDigitizerMgr::RunDigitizers]: Running SingleDigitizer " << m_SingleDigitizersList[i_D]->m_digitizerName <<" with "<< m_SingleDigitizersList[i_D]->m_DMlist.size() << " Digitizer Modules\n";
+			if (m_chainRandomStreams)
+				CLHEP::HepRandom::setTheEngine(m_singlesDigitizerEngines[i_D]);
+
+			if (m_SingleDigitizersList[i_D]->IsInPlaceChain())
+			{
+				m_SingleDigitizersList[i_D]->RunInPlaceChain();
+				continue;
+			}
 			//loop over all DMs of the current digitizer
 			for (size_t i_DM = 0; i_DM<m_SingleDigitizersList[i_D]->m_DMlist.size(); i_DM++)
 			{
@@ -452,6 +496,8 @@ void GateDigitizerMgr::RunDigitizers()
 			}
 
 		}
+		if (m_chainRandomStreams)
+			CLHEP::HepRandom::setTheEngine(mainEngine);
 
 		m_alreadyRun=true;
 }
@@ -474,13 +520,18 @@ void GateDigitizerMgr::RunCoincidenceSorters()
 		G4cout << "[GateDigitizerMgr::RunCoincidenceSorters]: launching CoincidenceSorters. N = " << m_CoincidenceSortersList.size() << "\n";
 
 
+	CLHEP::HepRandomEngine* mainEngine = CLHEP::HepRandom::getTheEngine();
 	for (size_t i = 0; i<m_CoincidenceSortersList.size(); i++) //DigitizerList
 		{
 			if (nVerboseLevel>1)
 				G4cout << "[GateDigitizerMgr::RunCoincidenceSorters]: Running CoincidenceSorter "<< m_CoincidenceSortersList[i]->m_coincidenceSorterName << "\n";
+			if (m_chainRandomStreams)
+				CLHEP::HepRandom::setTheEngine(m_coincidenceSorterEngines[i]);
 
 			m_CoincidenceSortersList[i]->Digitize();
 		}
+	if (m_chainRandomStreams)
+		CLHEP::HepRandom::setTheEngine(mainEngine);
 
 	m_alreadyRun=true;
 }
@@ -503,10 +554,13 @@ void GateDigitizerMgr::RunCoincidenceDigitizers()
 		   G4cout << "[GateDigitizerMgr::RunCoincidenceDigitizers]: launching CoincidenceDigitizers. N = " << m_CoincidenceDigitizersList.size() << "\n";
 		   //loops over all digitizers/collections
 		   	//collID get from G4DigiManager
+			CLHEP::HepRandomEngine* mainEngine = CLHEP::HepRandom::getTheEngine();
 			for (size_t i_D = 0; i_D<m_CoincidenceDigitizersList.size(); i_D++)
 			{
 				if (nVerboseLevel>1)
 					G4cout << "[GateDigitizerMgr::RunCoincidenceDigitizers]: Running CoincidenceDigitizer " << m_CoincidenceDigitizersList[i_D]->m_digitizerName <<" with "<< m_CoincidenceDigitizersList[i_D]->m_CDMlist.size() << " Digitizer Modules\n";
+				if (m_chainRandomStreams)
+					CLHEP::HepRandom::setTheEngine(m_coincidenceDigitizerEngines[i_D]);
 				//loop over all DMs of the current digitizer
 				for (size_t i_DM = 0; i_DM<m_CoincidenceDigitizersList[i_D]->m_CDMlist.size(); i_DM++)
 				{
@@ -517,6 +571,8 @@ void GateDigitizerMgr::RunCoincidenceDigitizers()
 				}
 
 			}
+			if (m_chainRandomStreams)
+				CLHEP::HepRandom::setTheEngine(mainEngine);
 
 	//m_alreadyRun=true;
 }
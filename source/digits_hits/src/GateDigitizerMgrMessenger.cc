@@ -63,6 +63,12 @@ GateDigitizerMgrMessenger::GateDigitizerMgrMessenger(GateDigitizerMgr* itsDigiti
   ListCmd = new G4UIcmdWithoutParameter(cmdName,this);
   ListCmd->SetGuidance(guidance);
 
+  cmdName = GetDirectoryName()+"setChainRandomStreams";
+  SetChainRandomStreamsCmd = new G4UIcmdWithABool(cmdName,this);
+  SetChainRandomStreamsCmd->SetGuidance("Give each digitizer and coincidence sorter its own random stream, seeded from the main seed and its name");
+  SetChainRandomStreamsCmd->SetParameterName("flag",true);
+  SetChainRandomStreamsCmd->SetDefaultValue(true);
+
   pInsertCmd->SetCandidates(DumpMap());
 
 //  G4cout << " FIN Constructor GateDigitizerMgrMessenger \n";
@@ -77,6 +83,7 @@ GateDigitizerMgrMessenger::~GateDigitizerMgrMessenger()
   delete ListChoicesCmd;
   delete pInsertCmd;
   delete SetChooseSDCmd;
+  delete SetChainRandomStreamsCmd;
   delete DefineNameCmd;
 }
 
@@ -89,6 +96,8 @@ void GateDigitizerMgrMessenger::SetNewValue(G4UIcommand* command,G4String newVal
     { m_newCollectionName = newValue; }
   else if (command == SetChooseSDCmd)
         {  m_SDname=newValue; }
+  else if (command == SetChainRandomStreamsCmd)
+        { GetDigitizerMgr()->SetChainRandomStreams(SetChainRandomStreamsCmd->GetNewBoolValue(newValue)); }
   else if( command==pInsertCmd )
     	{ DoInsertion(newValue); }
   else if( command==ListChoicesCmd )
@@ -13,6 +13,7 @@
 
 // gate
 #include "GateDoseActor.hh"
+#include "GateStoppingPowerTable.hh"
 #include "GateMiscFunctions.hh"
 
 // g4
@@ -62,9 +63,9 @@ GateDoseActor::GateDoseActor(G4String name, G4int depth):
   mOtherMaterial = "G4Water";
   //Others
   mIsNumberOfHitsImageEnabled = false;
-  mIsLastHitEventImageEnabled = false;
   mDoseAlgorithmType = "VolumeWeighting";
   mImportMassImage = "";
+  mMassCacheDirectory = "";
   mExportMassImage = "";
   mVolumeFilter = "";
   mMaterialFilter = "";
@@ -210,22 +211,11 @@ void GateDoseActor::Construct() {
   SetOriginTransformAndFlagToImage(mDoseToWaterImage);
   SetOriginTransformAndFlagToImage(mDoseToOtherMaterialImage);
   SetOriginTransformAndFlagToImage(mNumberOfHitsImage);
-  SetOriginTransformAndFlagToImage(mLastHitEventImage);
   SetOriginTransformAndFlagToImage(mMassImage);
 
   // Resize and allocate images
-  if (mIsEdepSquaredImageEnabled || mIsEdepUncertaintyImageEnabled ||
-      mIsDoseSquaredImageEnabled || mIsDoseUncertaintyImageEnabled ||
-      mIsDoseToWaterSquaredImageEnabled || mIsDoseToWaterUncertaintyImageEnabled ||
-      mIsDoseToOtherMaterialSquaredImageEnabled || mIsDoseToOtherMaterialUncertaintyImageEnabled)
-    {
-      mLastHitEventImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
-      mLastHitEventImage.Allocate();
-      mIsLastHitEventImageEnabled = true;
-    }
   //Edep
   if (mIsEdepImageEnabled) {
-    //  mEdepImage.SetLastHitEventImage(&mLastHitEventImage);
     mEdepImage.EnableSquaredImage(mIsEdepSquaredImageEnabled);
     mEdepImage.EnableUncertaintyImage(mIsEdepUncertaintyImageEnabled);
     // Force the computation of squared image if uncertainty is enabled
@@ -236,7 +226,6 @@ void GateDoseActor::Construct() {
   }
   //Dose
   if (mIsDoseImageEnabled) {
-    // mDoseImage.SetLastHitEventImage(&mLastHitEventImage);
     mDoseImage.EnableSquaredImage(mIsDoseSquaredImageEnabled);
     mDoseImage.EnableUncertaintyImage(mIsDoseUncertaintyImageEnabled);
     mDoseImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
@@ -329,6 +318,7 @@ void GateDoseActor::Construct() {
     mVoxelizedMass.SetMaterialFilter(mMaterialFilter);
     mVoxelizedMass.SetVolumeFilter(mVolumeFilter);
     mVoxelizedMass.SetExternalMassImage(mImportMassImage);
+    mVoxelizedMass.SetMassCacheDirectory(mMassCacheDirectory);
     mVoxelizedMass.Initialize(mVolumeName, &mDoseImage.GetValueImage());
     if (mExportMassImage != "") {
       mMassImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
@@ -379,7 +369,6 @@ void GateDoseActor::Construct() {
               "\tEdep squared      = " << mIsEdepSquaredImageEnabled << Gateendl <<
               "\tEdep uncertainty  = " << mIsEdepUncertaintyImageEnabled << Gateendl <<
               "\tNumber of hit     = " << mIsNumberOfHitsImageEnabled << Gateendl <<
-              "\t     (last hit)   = " << mIsLastHitEventImageEnabled << Gateendl <<
               "\tDose algorithm    = " << mDoseAlgorithmType << Gateendl <<
               "\tMass image (import) = " << mImportMassImage << Gateendl <<
               "\tMass image (export) = " << mExportMassImage << Gateendl <<
@@ -425,10 +414,6 @@ void GateDoseActor::SaveData() {
       mDoseToOtherMaterialImage.SaveData(mCurrentEvent+1, false);
   }
 
-  if (mIsLastHitEventImageEnabled) {
-    mLastHitEventImage.Fill(-1); // reset
-  }
-
   if (mIsNumberOfHitsImageEnabled) {
     G4String f = mNbOfHitsFilename;
     if (!mOverWriteFilesFlag) {
@@ -480,7 +465,6 @@ void GateDoseActor::SaveData() {
 
 //-----------------------------------------------------------------------------
 void GateDoseActor::ResetData() {
-  if (mIsLastHitEventImageEnabled) mLastHitEventImage.Fill(-1);
   if (mIsEdepImageEnabled) mEdepImage.Reset();
   if (mIsDoseImageEnabled) mDoseImage.Reset();
   if (mIsDoseToWaterImageEnabled) mDoseToWaterImage.Reset();
@@ -495,6 +479,9 @@ void GateDoseActor::BeginOfRunAction(const G4Run * r) {
   GateVActor::BeginOfRunAction(r);
   GateDebugMessage("Actor", 3, "GateDoseActor -- Begin of Run\n");
   mDose2WaterWarningFlag = true;
+  // Physics tables may have changed since the previous run
+  if (mIsDoseToWaterImageEnabled || mIsDoseToOtherMaterialImageEnabled)
+    GateStoppingPowerTable::GetInstance()->Clear();
   // ResetData(); // Do no reset here !! (when multiple run);
 }
 //-----------------------------------------------------------------------------
@@ -510,6 +497,18 @@ void GateDoseActor::BeginOfEventAction(const G4Event * e) {
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+// Fold the values of the event before a possible save (every n events)
+void GateDoseActor::EndOfEventAction(const G4Event * e) {
+  if (mIsEdepImageEnabled) mEdepImage.EndOfEvent();
+  if (mIsDoseImageEnabled) mDoseImage.EndOfEvent();
+  if (mIsDoseToWaterImageEnabled) mDoseToWaterImage.EndOfEvent();
+  if (mIsDoseToOtherMaterialImageEnabled) mDoseToOtherMaterialImage.EndOfEvent();
+  GateVActor::EndOfEventAction(e);
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateDoseActor::UserPreTrackActionInVoxel(const int /*index*/, const G4Track* track)
 {
@@ -550,17 +549,6 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
   if (mMaterialFilter != "" && mMaterialFilter != current_material->GetName())
     return;
 
-  // compute sameEvent
-  // sameEvent is false the first time some energy is deposited for each primary particle
-  bool sameEvent=true;
-  if (mIsLastHitEventImageEnabled) {
-    GateDebugMessage("Actor", 2,  "GateDoseActor -- UserSteppingActionInVoxel: Last event in index = " << mLastHitEventImage.GetValue(index) << Gateendl);
-    if (mCurrentEvent != mLastHitEventImage.GetValue(index)) {
-      sameEvent = false;
-      mLastHitEventImage.SetValue(index, mCurrentEvent);
-    }
-  }
-
   //---------------------------------------------------------------------------------
   // Volume weighting
   double density = current_material->GetDensity();
@@ -681,8 +669,6 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
   if (mIsDoseToWaterImageEnabled)
     {
       double cut =  DBL_MAX;
-      // dedx
-      double DEDX=0, DEDX_Water=0;
       //other material
       static G4Material * water = G4NistManager::Instance()->FindOrBuildMaterial("G4_WATER");
 
@@ -693,15 +679,11 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
       //For neutrons the dose is neglected - testing with 1.3 MeV photon beam or 150 MeV protons or 1500 MeV carbon ion beam showed that the error induced is < 0.01%
       //		when comparing dose and dosetowater in the material G4_WATER (we are systematically missing a little bit of dose of course with this solution)
       if (p == G4Gamma::Gamma())  p = G4Electron::Electron();
-      DEDX = emcalc->ComputeTotalDEDX(energy, p, current_material, cut);
-      DEDX_Water = emcalc->ComputeTotalDEDX(energy, p, water, cut);
-      //In current implementation, dose deposited directly by neutrons is neglected - the below lines prevent "inf or NaN"
-      if (DEDX==0 || DEDX_Water==0){
-      	doseToWater=0;
-      }
-      else{
-        doseToWater = dose*(DEDX_Water/1.0)/(DEDX/(density*e_SI));
-      }
+      // DEDX_Water/DEDX from the tabulated stopping powers. In current
+      // implementation, dose deposited directly by neutrons is neglected: the
+      // ratio is 0 when one of the dedx is 0 (prevent "inf or NaN")
+      double ratio = GateStoppingPowerTable::GetInstance()->GetTotalDEDXRatio(energy, p, current_material, water, cut);
+      doseToWater = dose*ratio*density*e_SI;
 
 //G4cout<<"Dose To Water " << doseToWater << G4endl;
 
@@ -804,15 +786,11 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
     //For neutrons the dose is neglected - testing with 1.3 MeV photon beam or 150 MeV protons or 1500 MeV carbon ion beam showed that the error induced is < 0.01%
     //		we are systematically missing a little bit of dose of course with this solution
     if (p == G4Gamma::Gamma())  p = G4Electron::Electron();
-    DEDX = emcalc->ComputeTotalDEDX(energy, p, current_material, cut);
-    DEDX_OtherMaterial = emcalc->ComputeTotalDEDX(energy, p, OtherMaterial, cut);
-    //In current implementation, dose deposited directly by neutrons is neglected - the below lines prevent "inf or NaN"
-    if (DEDX==0 || DEDX_OtherMaterial==0){
-      DoseToOtherMaterial=0;
-    }
-    else{
-      DoseToOtherMaterial = dose*(DEDX_OtherMaterial/(Density_OtherMaterial*e_SI))/(DEDX/(current_density*e_SI));
-    }
+    // DEDX_OtherMaterial/DEDX from the tabulated stopping powers. In current
+    // implementation, dose deposited directly by neutrons is neglected: the
+    // ratio is 0 when one of the dedx is 0 (prevent "inf or NaN")
+    double ratio = GateStoppingPowerTable::GetInstance()->GetTotalDEDXRatio(energy, p, current_material, OtherMaterial, cut);
+    DoseToOtherMaterial = dose*ratio*current_density/Density_OtherMaterial;
 
     GateDebugMessage("Actor", 2,  "GateDoseActor -- UserSteppingActionInVoxel:\tdose to OtherMaterial = "
                      << G4BestUnit(DoseToOtherMaterial, "Dose to OtherMaterial")
@@ -825,8 +803,7 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
     {
       if (mIsEdepUncertaintyImageEnabled || mIsEdepSquaredImageEnabled)
         {
-          if (sameEvent) mEdepImage.AddTempValue(index, edep);
-          else mEdepImage.AddValueAndUpdate(index, edep);
+          mEdepImage.AddTempValue(index, edep);
         }
       else
         {
@@ -840,8 +817,7 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
     {
       if (mIsDoseUncertaintyImageEnabled || mIsDoseSquaredImageEnabled)
         {
-          if (sameEvent) mDoseImage.AddTempValue(index, dose);
-          else mDoseImage.AddValueAndUpdate(index, dose);
+          mDoseImage.AddTempValue(index, dose);
         }
       else mDoseImage.AddValue(index, dose);
     }
@@ -851,8 +827,7 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
     {
       if (mIsDoseToWaterUncertaintyImageEnabled || mIsDoseToWaterSquaredImageEnabled)
         {
-          if (sameEvent) mDoseToWaterImage.AddTempValue(index, doseToWater);
-          else mDoseToWaterImage.AddValueAndUpdate(index, doseToWater);
+          mDoseToWaterImage.AddTempValue(index, doseToWater);
         }
       else mDoseToWaterImage.AddValue(index, doseToWater);
     }
@@ -862,8 +837,7 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
     {
       if (mIsDoseToOtherMaterialUncertaintyImageEnabled || mIsDoseToOtherMaterialSquaredImageEnabled)
         {
-          if (sameEvent) mDoseToOtherMaterialImage.AddTempValue(index, DoseToOtherMaterial);
-          else mDoseToOtherMaterialImage.AddValueAndUpdate(index, DoseToOtherMaterial);
+          mDoseToOtherMaterialImage.AddTempValue(index, DoseToOtherMaterial);
         }
       else mDoseToOtherMaterialImage.AddValue(index, DoseToOtherMaterial);
     }
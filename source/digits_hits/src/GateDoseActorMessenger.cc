@@ -47,6 +47,7 @@ GateDoseActorMessenger::GateDoseActorMessenger(GateDoseActor* sensor)
   pSetDoseAlgorithmCmd= 0;
   pImportMassImageCmd= 0;
   pExportMassImageCmd= 0;
+  pSetMassCacheDirectoryCmd= 0;
   pVolumeFilterCmd= 0;
   pMaterialFilterCmd= 0;
   pTestFlagCmd= 0;
@@ -93,6 +94,7 @@ GateDoseActorMessenger::~GateDoseActorMessenger()
   if(pSetDoseAlgorithmCmd) delete pSetDoseAlgorithmCmd;
   if(pImportMassImageCmd) delete pImportMassImageCmd;
   if(pExportMassImageCmd) delete pExportMassImageCmd;
+  if(pSetMassCacheDirectoryCmd) delete pSetMassCacheDirectoryCmd;
 
   if(pVolumeFilterCmd) delete pVolumeFilterCmd;
   if(pMaterialFilterCmd) delete pMaterialFilterCmd;
@@ -230,6 +232,12 @@ void GateDoseActorMessenger::BuildCommands(G4String base)
   pExportMassImageCmd->SetGuidance(guid);
   pExportMassImageCmd->SetParameterName("Export mass image",false);
 
+  n = base+"/setMassCacheDirectory";
+  pSetMassCacheDirectoryCmd = new G4UIcmdWithAString(n, this);
+  guid = G4String("Directory where the computed dosel masses are stored and reused (voxelized volumes only)");
+  pSetMassCacheDirectoryCmd->SetGuidance(guid);
+  pSetMassCacheDirectoryCmd->SetParameterName("Mass cache directory",false);
+
 
   n = base+"/setVolumeFilter";
   pVolumeFilterCmd = new G4UIcmdWithAString(n, this);
@@ -305,6 +313,7 @@ void GateDoseActorMessenger::SetNewValue(G4UIcommand* cmd, G4String newValue)
   if (cmd == pSetDoseAlgorithmCmd) pDoseActor->SetDoseAlgorithmType(newValue);
   if (cmd == pImportMassImageCmd) pDoseActor->ImportMassImage(newValue);
   if (cmd == pExportMassImageCmd) pDoseActor->ExportMassImage(newValue);
+  if (cmd == pSetMassCacheDirectoryCmd) pDoseActor->SetMassCacheDirectory(newValue);
   if (cmd == pVolumeFilterCmd) pDoseActor->VolumeFilter(newValue);
   if (cmd == pMaterialFilterCmd) pDoseActor->MaterialFilter(newValue);
   if (cmd ==pTestFlagCmd) pDoseActor->setTestFlag(pTestFlagCmd->GetNewBoolValue(newValue));
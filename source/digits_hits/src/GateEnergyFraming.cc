@@ -127,6 +127,15 @@ void GateEnergyFraming::Digitize()
 }
 
 
+void GateEnergyFraming::DigitizeInPlace(std::vector<GateDigi*>& digis)
+{
+	std::vector<G4bool> keep(digis.size());
+	for (size_t i=0; i<digis.size(); i++)
+		keep[i] = ( digis[i]->GetEnergy() >= m_min &&  digis[i]->GetEnergy() <= m_max );
+	RemoveRejectedDigis(digis, keep);
+}
+
+
 
 void GateEnergyFraming::DescribeMyself(size_t indent)
 {
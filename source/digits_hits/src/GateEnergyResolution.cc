@@ -70,14 +70,40 @@ GateEnergyResolution::~GateEnergyResolution()
 
 
 
-void GateEnergyResolution::Digitize()
+void GateEnergyResolution::CheckResolutionParameters() const
 {
-
 	if( m_resoMin!=0 && m_resoMax!=0 && m_reso!=0)
 	{
 		G4cout<<m_resoMin<<" "<< m_resoMax<<" "<<m_reso<<G4endl;
 		GateError("***ERROR*** Energy Resolution is ambiguous: you can set /fwhm OR range for resolutions with /fwhmMin and /fwhmMax!");
 	}
+}
+
+
+G4double GateEnergyResolution::BlurEnergy(G4double energy) const
+{
+	G4double reso = m_reso;
+	if( m_resoMin!=0 && m_resoMax!=0)
+		reso = G4RandFlat::shoot(m_resoMin, m_resoMax);
+
+	G4double resolution;
+	if (m_slope == 0 )
+		//Apply InverseSquareBlurringLaw
+		resolution = reso * sqrt(m_eref)/ sqrt(energy);
+	else
+		//Apply LinearBlurringLaw
+		resolution = m_slope * (energy - m_eref) + reso;
+
+	G4double sigma =(resolution*energy)/GateConstants::fwhm_to_sigma;
+
+	return G4RandGauss::shoot(energy,sigma);
+}
+
+
+void GateEnergyResolution::Digitize()
+{
+
+	CheckResolutionParameters();
 
 
 
@@ -95,7 +121,6 @@ void GateEnergyResolution::Digitize()
 
 	GateDigi* inputDigi;
 
-	G4double reso;
 
   if (IDC)
      {
@@ -106,33 +131,7 @@ void GateEnergyResolution::Digitize()
 	  {
 		  inputDigi=(*IDC)[i];
 
-		  if( m_resoMin!=0 && m_resoMax!=0)
-			  reso = G4RandFlat::shoot(m_resoMin, m_resoMax);
-		  else if (m_reso!=0)
-			  reso=m_reso;
-
-
-
-		  G4double energy= inputDigi->GetEnergy();
-		  G4double sigma;
-		  G4double resolution;
-
-		  if (m_slope == 0 )
-			  //Apply InverseSquareBlurringLaw
-		  {
-			  //G4cout<<"InverseSquareBlurringLaw"<<G4endl;
-			  resolution = reso * sqrt(m_eref)/ sqrt(energy);
-
-		  }
-		  else
-			  //Apply LinearBlurringLaw
-			  resolution = m_slope * (energy - m_eref) + reso;
-
-	      sigma =(resolution*energy)/GateConstants::fwhm_to_sigma;
-
-
-
-		  G4double outEnergy=G4RandGauss::shoot(energy,sigma);
+		  G4double outEnergy=BlurEnergy(inputDigi->GetEnergy());
 
 		  m_outputDigi = new GateDigi(*inputDigi);
 		  m_outputDigi->SetEnergy(outEnergy);
@@ -157,9 +156,19 @@ void GateEnergyResolution::Digitize()
 }
 
 
+void GateEnergyResolution::DigitizeInPlace(std::vector<GateDigi*>& digis)
+{
+	CheckResolutionParameters();
+
+	for (size_t i=0; i<digis.size(); i++)
+		digis[i]->SetEnergy(BlurEnergy(digis[i]->GetEnergy()));
+}
+
+
 
 void GateEnergyResolution::DescribeMyself(size_t indent )
 {
 	  G4cout << GateTools::Indent(indent) << "Resolution of " << m_reso  << " for " <<  G4BestUnit(m_eref,"Energy") << Gateendl;
 ;
 }
+
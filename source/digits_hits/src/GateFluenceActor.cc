@@ -21,7 +21,6 @@ GateFluenceActor::GateFluenceActor(G4String name, G4int depth) :
   mCurrentEvent = -1;
   mIsSquaredImageEnabled = false;
   mIsUncertaintyImageEnabled = false;
-  mIsLastHitEventImageEnabled = false;
   mIsNormalisationEnabled = false;
   mIsNumberOfHitsImageEnabled = false;
   pMessenger = new GateFluenceActorMessenger(this);
@@ -42,7 +41,6 @@ void GateFluenceActor::Construct()
 {
   GateDebugMessageInc("Actor", 4, "GateFluenceActor -- Construct - begin\n");
   GateVImageActor::Construct(); /* mImage is not allocated here */
-  mImage.Allocate();
 
   /* Enable callbacks */
   EnableBeginOfRunAction(true);
@@ -62,21 +60,13 @@ void GateFluenceActor::Construct()
   /* Read the response detector curve from an external file */
   mEnergyResponse.ReadResponseDetectorFile(mResponseFileName);
 
-  mImage.SetOrigin(mOrigin);
+  /* Origin, overwrite and storage flags (single precision, sparse) must be set before Allocate */
+  SetOriginTransformAndFlagToImage(mImage);
   mImageProcess.SetOrigin(mOrigin);
-  mLastHitEventImage.SetOrigin(mOrigin);
   mNumberOfHitsImage.SetOrigin(mOrigin);
 
-  mImage.SetOverWriteFilesFlag(mOverWriteFilesFlag);
   mImageProcess.SetOverWriteFilesFlag(mOverWriteFilesFlag);
 
-  if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled)
-    {
-      mLastHitEventImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
-      mLastHitEventImage.Allocate();
-      mIsLastHitEventImageEnabled = true;
-    }
-
   mImage.EnableSquaredImage(mIsSquaredImageEnabled);
   mImage.EnableUncertaintyImage(mIsUncertaintyImageEnabled);
   /* Force the computation of squared image if uncertainty is enabled */
@@ -159,16 +149,7 @@ void GateFluenceActor::SaveData()
             {
               mImageProcess.SaveData(mCurrentEvent + 1, false);
             }
-
-          if (mIsLastHitEventImageEnabled)
-            {
-              mLastHitEventImage.Fill(-1);
-            }
         }
-      if (mIsLastHitEventImageEnabled)
-        {
-          mLastHitEventImage.Fill(-1);
-        }/* reset */
     }
 
   /* Printing scatter of each order */
@@ -203,10 +184,6 @@ void GateFluenceActor::SaveData()
 
 void GateFluenceActor::ResetData()
 {
-  if (mIsLastHitEventImageEnabled)
-    {
-      mLastHitEventImage.Fill(-1);
-    }
   mImage.Reset();
   mImageProcess.Reset();
   mImage.Fill(0);
@@ -229,6 +206,17 @@ void GateFluenceActor::BeginOfEventAction(const G4Event * e)
   GateDebugMessage("Actor", 3, "GateFluenceActor -- Begin of Event: "<<mCurrentEvent << Gateendl);
 }
 
+/* Fold the fluence of the event before a possible save (every n events) */
+void GateFluenceActor::EndOfEventAction(const G4Event * e)
+{
+  mImage.EndOfEvent();
+  if (mIsScatterImageEnabled)
+    {
+      mImageProcess.EndOfEvent();
+    }
+  GateVActor::EndOfEventAction(e);
+}
+
 void GateFluenceActor::UserPostTrackActionInVoxel(const int /*index*/,
                                                   const G4Track * /*aTrack*/)
 {
@@ -262,27 +250,9 @@ void GateFluenceActor::UserSteppingActionInVoxel(const int index, const G4Step*
           respValue *= weight;
         }
 
-      bool sameEvent = true;
-      if (mIsLastHitEventImageEnabled)
-        {
-          GateDebugMessage( "Actor", 2, "GateFluenceActor -- UserSteppingActionInVoxel: Last event in index = " << mLastHitEventImage.GetValue(index) << Gateendl);
-          if (mCurrentEvent != mLastHitEventImage.GetValue(index))
-            {
-              sameEvent = false;
-              mLastHitEventImage.SetValue(index, mCurrentEvent);
-            }
-        }
-
       if (mIsUncertaintyImageEnabled || mIsSquaredImageEnabled)
         {
-          if (sameEvent)
-            {
-              mImage.AddTempValue(index, respValue);
-            }
-          else
-            {
-              mImage.AddValueAndUpdate(index, respValue);
-            }
+          mImage.AddTempValue(index, respValue);
         }
       else
         {
@@ -343,14 +313,7 @@ void GateFluenceActor::UserSteppingActionInVoxel(const int index, const G4Step*
 
               if (mIsUncertaintyImageEnabled || mIsSquaredImageEnabled)
                 {
-                  if (sameEvent)
-                    {
-                      mImageProcess.AddTempValue(index, respValue);
-                    }
-                  else
-                    {
-                      mImageProcess.AddValueAndUpdate(index, respValue);
-                    }
+                  mImageProcess.AddTempValue(index, respValue);
                 }
               else
                 {
@@ -373,14 +336,7 @@ void GateFluenceActor::UserSteppingActionInVoxel(const int index, const G4Step*
             {
               if (mIsUncertaintyImageEnabled || mIsSquaredImageEnabled)
                 {
-                  if (sameEvent)
-                    {
-                      mImageProcess.AddTempValue(index, respValue);
-                    }
-                  else
-                    {
-                      mImageProcess.AddValueAndUpdate(index, respValue);
-                    }
+                  mImageProcess.AddTempValue(index, respValue);
                 }
               else
                 {
@@ -24,10 +24,16 @@ GateHit::GateHit()
 : m_edep(0),
   m_stepLength(0),
   m_time(0.),
+  m_processHandle(0),
   m_PDGEncoding(0),
   m_trackID(0),
   m_parentID(0),
+  m_comptonVolumeNameHandle(0),
+  m_RayleighVolumeNameHandle(0),
+  m_volumeIDHandle(0),
+  m_outputVolumeIDHandle(0),
   m_systemID(-1),
+  m_postStepProcessHandle(0),
   m_sourceEnergy(-1),
   m_sourcePDG(0),
   m_nCrystalConv(0)
@@ -74,7 +80,7 @@ std::ostream& operator<<(std::ostream& flux, const GateHit& hit)
 {
   flux   << "("
 	 << "E=" << G4BestUnit(hit.m_edep,"Energy") << ", "
-	 << "proc=" << hit.m_process << ", "
+	 << "proc=" << hit.GetProcess() << ", "
 	 << "particle= " << ( (hit.m_PDGEncoding == 22) ? "gamma" : ( (hit.m_PDGEncoding == 11) ? "e-" : "?" ) ) << ", "
 	 << "track=" << hit.m_trackID  << " (son of " << hit.m_parentID    << ") " << ", "
 //	 << "outputID= " << hit.GetOutputVolumeID() << ", "
@@ -111,9 +117,9 @@ std::ofstream& operator<<(std::ofstream& flux, GateHit* hit)
 	 << " " << std::setw(3) << hit->m_photonID
 	 << " " << std::setw(4) << hit->m_nPhantomCompton
 	 << " " << std::setw(4) << hit->m_nPhantomRayleigh
-	 << " " << hit->m_process
-	 << " " << hit->m_comptonVolumeName
-	 << " " << hit->m_RayleighVolumeName
+	 << " " << hit->GetProcess()
+	 << " " << hit->GetComptonVolumeName()
+	 << " " << hit->GetRayleighVolumeName()
 	 << Gateendl;
 
   return flux;
@@ -35,6 +35,8 @@ GateImageActorMessenger::~GateImageActorMessenger()
   delete pHalfSizeCmd;
   delete pSizeCmd;
   delete pPositionCmd;
+  delete pSinglePrecisionTempImageCmd;
+  delete pSparseImagesCmd;
 }
 //-----------------------------------------------------------------------------
 
@@ -83,6 +85,16 @@ void GateImageActorMessenger::BuildCommands(G4String base)
   guidance = G4String("Sets  hit type ('pre', 'post', 'random' or 'middle'). Default is 'middle'.");
   pStepHitTypeCmd->SetGuidance(guidance);
 
+  bb = base +"/enableSinglePrecisionTempImage";
+  pSinglePrecisionTempImageCmd = new G4UIcmdWithABool(bb,this);
+  guidance = G4String("Store the values of the current event in single precision (squared/uncertainty images). Default is false.");
+  pSinglePrecisionTempImageCmd->SetGuidance(guidance);
+
+  bb = base +"/enableSparseImages";
+  pSparseImagesCmd = new G4UIcmdWithABool(bb,this);
+  guidance = G4String("Store the images as 8x8x8 bricks allocated on first touch, for large and mostly empty grids. Default is false.");
+  pSparseImagesCmd->SetGuidance(guidance);
+
 }
 //-----------------------------------------------------------------------------
 
@@ -94,6 +106,8 @@ void GateImageActorMessenger::SetNewValue(G4UIcommand* cmd, G4String newValue) {
   if (cmd == pSizeCmd)        pImageActor->SetSize(pSizeCmd->GetNew3VectorValue(newValue));
   if (cmd == pPositionCmd)    pImageActor->SetPosition(pPositionCmd->GetNew3VectorValue(newValue));
   if (cmd == pStepHitTypeCmd) pImageActor->SetStepHitType(newValue);
+  if (cmd == pSinglePrecisionTempImageCmd) pImageActor->EnableSinglePrecisionTempImage(pSinglePrecisionTempImageCmd->GetNewBoolValue(newValue));
+  if (cmd == pSparseImagesCmd) pImageActor->EnableSparseImages(pSparseImagesCmd->GetNewBoolValue(newValue));
   GateActorMessenger::SetNewValue(cmd,newValue);
 }
 //-----------------------------------------------------------------------------
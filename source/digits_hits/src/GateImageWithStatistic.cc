@@ -14,16 +14,55 @@
 #include "GateImageWithStatistic.hh"
 #include "GateMessageManager.hh"
 #include "GateMiscFunctions.hh"
+#include <algorithm>
+#include <fstream>
+
+std::vector<GateImageWithStatistic*> GateImageWithStatistic::mListOfImages;
+
+//-----------------------------------------------------------------------------
+namespace {
+  // The temporary image is a GateImageDouble or a GateImage (single precision).
+  // Only the listed voxels are folded into the value and squared images, then
+  // reset to zero.
+  template<class ImageType, class TempImageType>
+  void AddTouchedVoxels(ImageType & image, ImageType * squaredImage,
+                        TempImageType & tempImage, const std::vector<int> & touchedVoxels)
+  {
+    for (auto index : touchedVoxels) {
+      double v = tempImage.GetValue(index);
+      if (v == 0) continue; // listed twice
+      image.AddValue(index, v);
+      if (squaredImage) squaredImage->AddValue(index, v*v);
+      tempImage.SetValue(index, 0);
+    }
+  }
+
+  // Chetty2006 p1250 : relative statistical uncertainty
+  // exactly same than Ma2002
+  inline double RelativeUncertainty(double mean, double squared, int N)
+  {
+    if (mean != 0.0 && N != 1 && squared != 0.0)
+      return sqrt( (1.0/(N-1))*(squared/N - pow(mean/N, 2)))/(mean/N);
+    return 1;
+  }
+}
+//-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
 /// Constructor
 GateImageWithStatistic::GateImageWithStatistic()  {
   mIsSquaredImageEnabled = false;
   mIsUncertaintyImageEnabled = false;
+  mIsSinglePrecisionTempImageEnabled = false;
+  mIsSparseImageEnabled = false;
   mIsValuesMustBeScaled = false;
   mOverWriteFilesFlag = true;
   mNormalizedToMax = false;
   mNormalizedToIntegral = false;
+  mIsSaved = false;
+  mLastNormalise = false;
+  mLastNumberOfEvents = 0;
+  mListOfImages.push_back(this);
 }
 //-----------------------------------------------------------------------------
 
@@ -31,6 +70,7 @@ GateImageWithStatistic::GateImageWithStatistic()  {
 //-----------------------------------------------------------------------------
 /// Destructor
 GateImageWithStatistic::~GateImageWithStatistic()  {
+  mListOfImages.erase(std::remove(mListOfImages.begin(), mListOfImages.end(), this), mListOfImages.end());
 }
 //-----------------------------------------------------------------------------
 
@@ -40,9 +80,15 @@ void GateImageWithStatistic::SetOrigin(G4ThreeVector o) {
   mValueImage.SetOrigin(o);
   mSquaredImage.SetOrigin(o);
   mTempImage.SetOrigin(o);
+  mSinglePrecisionTempImage.SetOrigin(o);
   mUncertaintyImage.SetOrigin(o);
   mScaledValueImage.SetOrigin(o);
   mScaledSquaredImage.SetOrigin(o);
+  mSparseValueImage.SetOrigin(o);
+  mSparseSquaredImage.SetOrigin(o);
+  mSparseTempImage.SetOrigin(o);
+  mSparseUncertaintyImage.SetOrigin(o);
+  mSparseScaledImage.SetOrigin(o);
 }
 //-----------------------------------------------------------------------------
 
@@ -52,9 +98,15 @@ void GateImageWithStatistic::SetTransformMatrix(const G4RotationMatrix & m) {
   mValueImage.SetTransformMatrix(m);
   mSquaredImage.SetTransformMatrix(m);
   mTempImage.SetTransformMatrix(m);
+  mSinglePrecisionTempImage.SetTransformMatrix(m);
   mUncertaintyImage.SetTransformMatrix(m);
   mScaledValueImage.SetTransformMatrix(m);
   mScaledSquaredImage.SetTransformMatrix(m);
+  mSparseValueImage.SetTransformMatrix(m);
+  mSparseSquaredImage.SetTransformMatrix(m);
+  mSparseTempImage.SetTransformMatrix(m);
+  mSparseUncertaintyImage.SetTransformMatrix(m);
+  mSparseScaledImage.SetTransformMatrix(m);
 }
 //-----------------------------------------------------------------------------
 
@@ -72,18 +124,28 @@ void GateImageWithStatistic::SetResolutionAndHalfSize(const G4ThreeVector & reso
                                                       const G4ThreeVector & halfSize,
                                                       const G4ThreeVector & position)  {
 
+  if (mIsSparseImageEnabled) {
+    mSparseValueImage.SetResolutionAndHalfSize(resolution, halfSize, position);
+    mSparseSquaredImage.SetResolutionAndHalfSize(resolution, halfSize, position);
+    mSparseTempImage.SetResolutionAndHalfSize(resolution, halfSize, position);
+    mSparseUncertaintyImage.SetResolutionAndHalfSize(resolution, halfSize, position);
+    mSparseScaledImage.SetResolutionAndHalfSize(resolution, halfSize, position);
+    return;
+  }
   mValueImage.SetResolutionAndHalfSize(resolution, halfSize, position);
   if (mIsUncertaintyImageEnabled) {
     mUncertaintyImage.SetResolutionAndHalfSize(resolution, halfSize, position);
     if (!mIsSquaredImageEnabled) {
       mSquaredImage.SetResolutionAndHalfSize(resolution, halfSize, position);
       mTempImage.SetResolutionAndHalfSize(resolution, halfSize, position);
+      mSinglePrecisionTempImage.SetResolutionAndHalfSize(resolution, halfSize, position);
       mScaledSquaredImage.SetResolutionAndHalfSize(resolution, halfSize, position);
     }
   }
   if (mIsSquaredImageEnabled) {
     mSquaredImage.SetResolutionAndHalfSize(resolution, halfSize, position);
     mTempImage.SetResolutionAndHalfSize(resolution, halfSize, position);
+    mSinglePrecisionTempImage.SetResolutionAndHalfSize(resolution, halfSize, position);
     mScaledSquaredImage.SetResolutionAndHalfSize(resolution, halfSize, position);
   }
 
@@ -104,19 +166,29 @@ void GateImageWithStatistic::SetResolutionAndHalfSize(const G4ThreeVector & reso
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::SetResolutionAndHalfSizeCylinder(const G4ThreeVector & resolution,
 						      const G4ThreeVector & halfSize, const G4ThreeVector & position)  {
-  
+
+  if (mIsSparseImageEnabled) {
+    mSparseValueImage.SetResolutionAndHalfSizeCylinder(resolution, halfSize, position);
+    mSparseSquaredImage.SetResolutionAndHalfSizeCylinder(resolution, halfSize, position);
+    mSparseTempImage.SetResolutionAndHalfSizeCylinder(resolution, halfSize, position);
+    mSparseUncertaintyImage.SetResolutionAndHalfSizeCylinder(resolution, halfSize, position);
+    mSparseScaledImage.SetResolutionAndHalfSizeCylinder(resolution, halfSize, position);
+    return;
+  }
   mValueImage.SetResolutionAndHalfSizeCylinder(resolution, halfSize, position);
   if (mIsUncertaintyImageEnabled) {
     mUncertaintyImage.SetResolutionAndHalfSizeCylinder(resolution, halfSize, position);
     if (!mIsSquaredImageEnabled) {
       mSquaredImage.SetResolutionAndHalfSizeCylinder(resolution, halfSize, position);
       mTempImage.SetResolutionAndHalfSizeCylinder(resolution, halfSize, position);
+      mSinglePrecisionTempImage.SetResolutionAndHalfSizeCylinder(resolution, halfSize, position);
       mScaledSquaredImage.SetResolutionAndHalfSizeCylinder(resolution, halfSize, position);
     }
   }
   if (mIsSquaredImageEnabled) {
     mSquaredImage.SetResolutionAndHalfSizeCylinder(resolution, halfSize, position);
     mTempImage.SetResolutionAndHalfSizeCylinder(resolution, halfSize, position);
+    mSinglePrecisionTempImage.SetResolutionAndHalfSizeCylinder(resolution, halfSize, position);
     mScaledSquaredImage.SetResolutionAndHalfSizeCylinder(resolution, halfSize, position);
   }
 
@@ -126,56 +198,81 @@ void GateImageWithStatistic::SetResolutionAndHalfSizeCylinder(const G4ThreeVecto
 
 
 //-----------------------------------------------------------------------------
+// The uncertainty and scaled images are not allocated here, SaveData
+// allocates them while they are computed and written.
 void GateImageWithStatistic::Allocate() {
-  mValueImage.Allocate();
-  if (mIsUncertaintyImageEnabled) {
-    mUncertaintyImage.Allocate();
-    if (!mIsSquaredImageEnabled) {
-      mSquaredImage.Allocate();
-      mTempImage.Allocate();
-      if (mIsValuesMustBeScaled) mScaledSquaredImage.Allocate();
+  if (mIsSparseImageEnabled) {
+    mSparseValueImage.Allocate();
+    if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) {
+      mSparseSquaredImage.Allocate();
+      mSparseTempImage.Allocate();
     }
+    return;
   }
-  if (mIsSquaredImageEnabled) {
+  mValueImage.Allocate();
+  if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) {
     mSquaredImage.Allocate();
-    mTempImage.Allocate();
-    if (mIsValuesMustBeScaled) mScaledSquaredImage.Allocate();
+    if (mIsSinglePrecisionTempImageEnabled) mSinglePrecisionTempImage.Allocate();
+    else mTempImage.Allocate();
   }
-  if (mIsValuesMustBeScaled) mScaledValueImage.Allocate();
 }
 //-----------------------------------------------------------------------------
 
 
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::Reset(double val) {
-  mValueImage.Fill(val);
-  if (mIsUncertaintyImageEnabled) {
-    mUncertaintyImage.Fill(0.0);
-    if (!mIsSquaredImageEnabled) {
-      mSquaredImage.Fill(val*val);
-      mTempImage.Fill(0.0);
-      if (mIsValuesMustBeScaled) mScaledSquaredImage.Fill(0.0);
+  mTouchedVoxels.clear();
+  if (mIsSparseImageEnabled) {
+    mSparseValueImage.Fill(val);
+    if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) {
+      mSparseSquaredImage.Fill(val*val);
+      mSparseTempImage.Fill(0.0);
     }
+    return;
   }
-  if (mIsSquaredImageEnabled) {
+  mValueImage.Fill(val);
+  if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) {
     mSquaredImage.Fill(val*val);
     mTempImage.Fill(0.0);
-    if (mIsValuesMustBeScaled) mScaledSquaredImage.Fill(0.0);
+    mSinglePrecisionTempImage.Fill(0.0);
   }
-  if (mIsValuesMustBeScaled) mScaledValueImage.Fill(0.0);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+unsigned long GateImageWithStatistic::GetMemorySize() const {
+  return mValueImage.GetMemorySize() + mSquaredImage.GetMemorySize() +
+    mTempImage.GetMemorySize() + mSinglePrecisionTempImage.GetMemorySize() +
+    mUncertaintyImage.GetMemorySize() + mScaledValueImage.GetMemorySize() +
+    mScaledSquaredImage.GetMemorySize() + mTouchedVoxels.capacity()*sizeof(int) +
+    mSparseValueImage.GetMemorySize() + mSparseSquaredImage.GetMemorySize() +
+    mSparseTempImage.GetMemorySize() + mSparseUncertaintyImage.GetMemorySize() +
+    mSparseScaledImage.GetMemorySize();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+unsigned long GateImageWithStatistic::GetTransientMemorySize() const {
+  if (mIsValuesMustBeScaled || mIsUncertaintyImageEnabled || mNormalizedToMax || mNormalizedToIntegral)
+    return mValueImage.GetMemorySize() + mSparseValueImage.GetMemorySize();
+  return 0;
 }
 //-----------------------------------------------------------------------------
 
 
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::Fill(double value) {
-  mValueImage.Fill(value);
+  if (mIsSparseImageEnabled) mSparseValueImage.Fill(value);
+  else mValueImage.Fill(value);
 }
 //-----------------------------------------------------------------------------
 
 
 //-----------------------------------------------------------------------------
 double GateImageWithStatistic::GetValue(const int index) {
+  if (mIsSparseImageEnabled) return mSparseValueImage.GetValue(index);
   return mValueImage.GetValue(index);
 }
 //-----------------------------------------------------------------------------
@@ -183,7 +280,8 @@ double GateImageWithStatistic::GetValue(const int index) {
 
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::SetValue(const int index, double value) {
-  mValueImage.SetValue(index, value);
+  if (mIsSparseImageEnabled) mSparseValueImage.SetValue(index, value);
+  else mValueImage.SetValue(index, value);
 }
 //-----------------------------------------------------------------------------
 
@@ -191,15 +289,29 @@ void GateImageWithStatistic::SetValue(const int index, double value) {
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::AddValue(const int index, double value) {
   GateDebugMessage("Actor", 2, "AddValue index=" << index << " value=" << value << Gateendl);
-  mValueImage.AddValue(index, value);
+  if (mIsSparseImageEnabled) mSparseValueImage.AddValue(index, value);
+  else mValueImage.AddValue(index, value);
 }
 //-----------------------------------------------------------------------------
 
 
 //-----------------------------------------------------------------------------
+// The voxel is listed the first time it gets a value since the last fold
 void GateImageWithStatistic::AddTempValue(const int index, double value) {
   GateDebugMessage("Actor", 2, "AddTempValue index=" << index << " value=" << value << Gateendl);
-  mTempImage.AddValue(index, value);
+  if (value == 0) return;
+  if (mIsSparseImageEnabled) {
+    if (mSparseTempImage.GetValue(index) == 0) mTouchedVoxels.push_back(index);
+    mSparseTempImage.AddValue(index, value);
+  }
+  else if (mIsSinglePrecisionTempImageEnabled) {
+    if (mSinglePrecisionTempImage.GetValue(index) == 0) mTouchedVoxels.push_back(index);
+    mSinglePrecisionTempImage.AddValue(index, value);
+  }
+  else {
+    if (mTempImage.GetValue(index) == 0) mTouchedVoxels.push_back(index);
+    mTempImage.AddValue(index, value);
+  }
 }
 //-----------------------------------------------------------------------------
 
@@ -208,15 +320,53 @@ void GateImageWithStatistic::AddTempValue(const int index, double value) {
 void GateImageWithStatistic::AddValueAndUpdate(const int index, double value) {
 
   GateDebugMessageInc("Actor", 2, "AddValue and update -- start: "<<mTempImage.GetSize() << Gateendl);
-  double tmp = mTempImage.GetValue(index);
+  double tmp;
+  if (mIsSparseImageEnabled) {
+    tmp = mSparseTempImage.GetValue(index);
+    mSparseTempImage.SetValue(index, value);
+    if (tmp == 0 && value != 0) mTouchedVoxels.push_back(index);
+    mSparseValueImage.AddValue(index, tmp);
+    if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) mSparseSquaredImage.AddValue(index, tmp*tmp);
+    return;
+  }
+  if (mIsSinglePrecisionTempImageEnabled) {
+    tmp = mSinglePrecisionTempImage.GetValue(index);
+    mSinglePrecisionTempImage.SetValue(index, value);
+  }
+  else {
+    tmp = mTempImage.GetValue(index);
+    mTempImage.SetValue(index, value);
+  }
+  if (tmp == 0 && value != 0) mTouchedVoxels.push_back(index);
   mValueImage.AddValue(index, tmp);
   if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) mSquaredImage.AddValue(index, tmp*tmp);
-  mTempImage.SetValue(index, value);
   GateDebugMessageDec("Actor", 2, "AddValue and update -- end"<< Gateendl);
 }
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+// Fold the values of the current event into the value and squared images.
+// Only the voxels touched during the event are visited.
+void GateImageWithStatistic::EndOfEvent() {
+  if (mTouchedVoxels.empty()) return;
+  if (mIsSparseImageEnabled) {
+    GateSparseImageDouble * squaredImage = 0;
+    if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) squaredImage = &mSparseSquaredImage;
+    AddTouchedVoxels(mSparseValueImage, squaredImage, mSparseTempImage, mTouchedVoxels);
+    mTouchedVoxels.clear();
+    return;
+  }
+  GateImageDouble * squaredImage = 0;
+  if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) squaredImage = &mSquaredImage;
+  if (mIsSinglePrecisionTempImageEnabled)
+    AddTouchedVoxels(mValueImage, squaredImage, mSinglePrecisionTempImage, mTouchedVoxels);
+  else AddTouchedVoxels(mValueImage, squaredImage, mTempImage, mTouchedVoxels);
+  mTouchedVoxels.clear();
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::SetFilename(G4String f) {
   mFilename = f;
@@ -233,6 +383,10 @@ void GateImageWithStatistic::SetFilename(G4String f) {
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::SaveData(int numberOfEvents, bool normalise) {
 
+  mIsSaved = true;
+  mLastNormalise = normalise;
+  mLastNumberOfEvents = numberOfEvents;
+
   // Filename
   if (!mOverWriteFilesFlag) {
     mFilename = GetSaveCurrentFilename(mInitialFilename);
@@ -241,17 +395,17 @@ void GateImageWithStatistic::SaveData(int numberOfEvents, bool normalise) {
   }
 
   double factor=1.0;
-  if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) { UpdateImage(); }
-  if (mIsSquaredImageEnabled) { UpdateSquaredImage(); }
-  if (mIsUncertaintyImageEnabled) {
-    if (!mIsSquaredImageEnabled) UpdateSquaredImage();
-    UpdateUncertaintyImage(numberOfEvents);
-  }
+  if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) EndOfEvent();
 
   if (mIsValuesMustBeScaled == true) {
     factor = mScaleFactor;
   }
 
+  if (mIsSparseImageEnabled) {
+    SaveSparseData(numberOfEvents, normalise, factor);
+    return;
+  }
+
   // If normalize, change the scale factor according to max or sum
   if (normalise) {
     mIsValuesMustBeScaled = true;
@@ -276,63 +430,38 @@ void GateImageWithStatistic::SaveData(int numberOfEvents, bool normalise) {
     if (mIsSquaredImageEnabled) mSquaredImage.Write(mSquaredFilename);
   }
   else {
-    GateImageDouble::iterator po = mScaledValueImage.begin();
-    GateImageDouble::iterator pi = mValueImage.begin();
-    GateImageDouble::const_iterator pe = mValueImage.end();
-    if (mIsSquaredImageEnabled){
-      GateImageDouble::iterator pii = mSquaredImage.begin();
-      GateImageDouble::iterator poo = mScaledSquaredImage.begin();
-      while (pi != pe) {
-	*po = (*pi)*mScaleFactor;
-	*poo = (*pii)*mScaleFactor*mScaleFactor;
-	++pi;
-	++po;
-	++pii;
-	++poo;
-      }
-      mScaledSquaredImage.Write(mSquaredFilename);
-    }
-    else {
-      while (pi != pe) {
-	*po = (*pi)*mScaleFactor;
-	++pi;
-	++po;
-      }
-    }
-    mScaledValueImage.Write(mFilename);
+    WriteScaledImage(mValueImage, mScaledValueImage, mScaleFactor, mFilename);
+    if (mIsSquaredImageEnabled)
+      WriteScaledImage(mSquaredImage, mScaledSquaredImage, mScaleFactor*mScaleFactor, mSquaredFilename);
     SetScaleFactor(factor); // set back previous scaling factor
   }
 
-  if (mIsUncertaintyImageEnabled) mUncertaintyImage.Write(mUncertaintyFilename);
-}
-//-----------------------------------------------------------------------------
-
-
-//-----------------------------------------------------------------------------
-void GateImageWithStatistic::UpdateImage() {
-  GateImageDouble::iterator pi = mValueImage.begin();
-  GateImageDouble::iterator pt = mTempImage.begin();
-  GateImageDouble::const_iterator pe = mValueImage.end();
-  while (pi != pe) {
-    *pi += (*pt);
-    ++pt;
-    ++pi;
+  if (mIsUncertaintyImageEnabled) {
+    mUncertaintyImage.Allocate();
+    UpdateUncertaintyImage(numberOfEvents);
+    mUncertaintyImage.Write(mUncertaintyFilename);
+    mUncertaintyImage.Deallocate();
   }
 }
 //-----------------------------------------------------------------------------
 
 
 //-----------------------------------------------------------------------------
-void GateImageWithStatistic::UpdateSquaredImage() {
-  GateImageDouble::iterator pi = mSquaredImage.begin();
-  GateImageDouble::iterator pt = mTempImage.begin();
-  GateImageDouble::const_iterator pe = mSquaredImage.end();
+// The scaled image only exists while it is written
+void GateImageWithStatistic::WriteScaledImage(const GateImageDouble & image, GateImageDouble & scaledImage,
+                                              double scale, const G4String & filename)
+{
+  scaledImage.Allocate();
+  GateImageDouble::iterator po = scaledImage.begin();
+  GateImageDouble::const_iterator pi = image.begin();
+  GateImageDouble::const_iterator pe = image.end();
   while (pi != pe) {
-    *pi += (*pt)*(*pt);
-    *pt = 0;
-    ++pt;
+    *po = (*pi)*scale;
     ++pi;
+    ++po;
   }
+  scaledImage.Write(filename);
+  scaledImage.Deallocate();
 }
 //-----------------------------------------------------------------------------
 
@@ -360,12 +489,8 @@ void GateImageWithStatistic::UpdateUncertaintyImage(int numberOfEvents)
      *po = sqrt( (N*squared - mean*mean) / ((N-1)*(mean*mean)) );
      else *po = 1;*/
 
-    // Chetty2006 p1250 : relative statistical uncertainty
-    // exactly same than Ma2002
-    if (mean != 0.0 && N != 1 && squared != 0.0){
-      *po = sqrt( (1.0/(N-1))*(squared/N - pow(mean/N, 2)))/(mean/N);
-    }
-    else *po = 1;
+    // Chetty2006 p1250 (see RelativeUncertainty)
+    *po = RelativeUncertainty(mean, squared, N);
 
     /*
     // Ma2002 p1679 : relative statistical uncertainty (estimation)
@@ -389,4 +514,239 @@ void GateImageWithStatistic::UpdateUncertaintyImage(int numberOfEvents)
 }
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+// Same as the end of SaveData, only the allocated bricks are visited
+void GateImageWithStatistic::SaveSparseData(int numberOfEvents, bool normalise, double factor)
+{
+  const int brickVolume = GateSparseImageDouble::BrickVolume;
+
+  // If normalize, change the scale factor according to max or sum
+  if (normalise) {
+    mIsValuesMustBeScaled = true;
+    double sum = 0.0;
+    double max = 0.0;
+    for (unsigned long b=0; b<mSparseValueImage.GetNumberOfBricks(); b++) {
+      const double * p = mSparseValueImage.GetBrick(b);
+      if (!p) continue;
+      for (int i=0; i<brickVolume; i++) {
+        if (p[i] > max) max = p[i];
+        sum += p[i]*factor;
+      }
+    }
+    if (mNormalizedToMax) SetScaleFactor(factor*1.0/max);
+    if (mNormalizedToIntegral) SetScaleFactor(factor*1.0/sum);
+  }
+
+  GateMessage("Actor", 1, "Save " << mFilename << " with scaling = "
+              << mScaleFactor << "(" << mIsValuesMustBeScaled << "), "
+              << mSparseValueImage.GetNumberOfAllocatedBricks() << "/"
+              << mSparseValueImage.GetNumberOfBricks() << " bricks\n");
+
+  if (!mIsValuesMustBeScaled) {
+    mSparseValueImage.Write(mFilename);
+    if (mIsSquaredImageEnabled) mSparseSquaredImage.Write(mSquaredFilename);
+  }
+  else {
+    WriteScaledImage(mSparseValueImage, mSparseScaledImage, mScaleFactor, mFilename);
+    if (mIsSquaredImageEnabled)
+      WriteScaledImage(mSparseSquaredImage, mSparseScaledImage, mScaleFactor*mScaleFactor, mSquaredFilename);
+    SetScaleFactor(factor); // set back previous scaling factor
+  }
+
+  if (mIsUncertaintyImageEnabled) {
+    // The uncertainty of the voxels without value is 1
+    mSparseUncertaintyImage.Allocate();
+    mSparseUncertaintyImage.Fill(1.0);
+    for (unsigned long b=0; b<mSparseValueImage.GetNumberOfBricks(); b++) {
+      const double * pv = mSparseValueImage.GetBrick(b);
+      if (!pv) continue;
+      const double * ps = mSparseSquaredImage.GetBrick(b);
+      double * po = mSparseUncertaintyImage.GetOrAllocateBrick(b);
+      for (int i=0; i<brickVolume; i++)
+        po[i] = RelativeUncertainty(pv[i], ps ? ps[i] : 0.0, numberOfEvents);
+    }
+    mSparseUncertaintyImage.Write(mUncertaintyFilename);
+    mSparseUncertaintyImage.Deallocate();
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::WriteScaledImage(const GateSparseImageDouble & image,
+                                              GateSparseImageDouble & scaledImage,
+                                              double scale, const G4String & filename)
+{
+  scaledImage.Allocate();
+  scaledImage.Fill(image.GetBackgroundValue()*scale);
+  for (unsigned long b=0; b<image.GetNumberOfBricks(); b++) {
+    const double * pi = image.GetBrick(b);
+    if (!pi) continue;
+    double * po = scaledImage.GetOrAllocateBrick(b);
+    for (int i=0; i<GateSparseImageDouble::BrickVolume; i++) po[i] = pi[i]*scale;
+  }
+  scaledImage.Write(filename);
+  scaledImage.Deallocate();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Only the blocks of mBlockSize voxels holding a non-zero value are written,
+// each one preceded by its index; the list ends with an invalid index. Files
+// (and reading) thus scale with the touched part of the image only.
+void GateImageWithStatistic::WriteTouchedBlocks(GateImageDouble & image, std::ostream & os)
+{
+  const unsigned long size = image.end()-image.begin();
+  os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  for (unsigned long start=0; start<size; start+=mBlockSize) {
+    const unsigned long n = std::min(mBlockSize, size-start);
+    GateImageDouble::const_iterator pb = image.begin()+start;
+    if (std::all_of(pb, pb+n, [](double v) { return v == 0.0; })) continue;
+    const unsigned long block = start/mBlockSize;
+    os.write(reinterpret_cast<const char*>(&block), sizeof(block));
+    os.write(reinterpret_cast<const char*>(&(*pb)), n*sizeof(double));
+  }
+  const unsigned long end = size/mBlockSize+1;
+  os.write(reinterpret_cast<const char*>(&end), sizeof(end));
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::AddTouchedBlocks(GateImageDouble & image, std::istream & is, const G4String & filename)
+{
+  const unsigned long size = image.end()-image.begin();
+  unsigned long fileSize = 0;
+  is.read(reinterpret_cast<char*>(&fileSize), sizeof(fileSize));
+  if (fileSize != size)
+    GateError("The image sizes in '" << filename << "' do not match the current images");
+  std::vector<double> values(mBlockSize);
+  unsigned long block = 0;
+  is.read(reinterpret_cast<char*>(&block), sizeof(block));
+  while (is && block*mBlockSize < size) {
+    const unsigned long start = block*mBlockSize;
+    const unsigned long n = std::min(mBlockSize, size-start);
+    is.read(reinterpret_cast<char*>(values.data()), n*sizeof(double));
+    GateImageDouble::iterator po = image.begin()+start;
+    for (unsigned long i=0; i<n; i++, ++po) *po += values[i];
+    is.read(reinterpret_cast<char*>(&block), sizeof(block));
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Same as WriteTouchedBlocks with the allocated bricks of a sparse image
+void GateImageWithStatistic::WriteAllocatedBricks(GateSparseImageDouble & image, std::ostream & os)
+{
+  const unsigned long size = image.GetNumberOfBricks();
+  os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  for (unsigned long b=0; b<size; b++) {
+    const double * p = image.GetBrick(b);
+    if (!p) continue;
+    os.write(reinterpret_cast<const char*>(&b), sizeof(b));
+    os.write(reinterpret_cast<const char*>(p), GateSparseImageDouble::BrickVolume*sizeof(double));
+  }
+  os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::AddAllocatedBricks(GateSparseImageDouble & image, std::istream & is, const G4String & filename)
+{
+  const unsigned long size = image.GetNumberOfBricks();
+  unsigned long fileSize = 0;
+  is.read(reinterpret_cast<char*>(&fileSize), sizeof(fileSize));
+  if (fileSize != size)
+    GateError("The image sizes in '" << filename << "' do not match the current images");
+  std::vector<double> values(GateSparseImageDouble::BrickVolume);
+  unsigned long b = 0;
+  is.read(reinterpret_cast<char*>(&b), sizeof(b));
+  while (is && b < size) {
+    is.read(reinterpret_cast<char*>(values.data()), values.size()*sizeof(double));
+    double * po = image.GetOrAllocateBrick(b);
+    for (unsigned long i=0; i<values.size(); i++) po[i] += values[i];
+    is.read(reinterpret_cast<char*>(&b), sizeof(b));
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Write the raw (unscaled) value and squared accumulators of every image, as
+// they are after their last SaveData, so that another process can add them.
+void GateImageWithStatistic::WriteAccumulatorsOfAllImages(const G4String & filename)
+{
+  std::ofstream os(filename, std::ios::out | std::ios::binary);
+  if (!os) GateError("Cannot write the image accumulators to '" << filename << "'");
+  unsigned long n = mListOfImages.size();
+  os.write(reinterpret_cast<const char*>(&n), sizeof(n));
+  for (auto image : mListOfImages) {
+    long nbEvents = image->mIsSaved ? image->mLastNumberOfEvents : -1;
+    os.write(reinterpret_cast<const char*>(&nbEvents), sizeof(nbEvents));
+    os.write(reinterpret_cast<const char*>(&image->mLastNormalise), sizeof(bool));
+    if (image->mIsSparseImageEnabled) {
+      WriteAllocatedBricks(image->mSparseValueImage, os);
+      WriteAllocatedBricks(image->mSparseSquaredImage, os);
+    }
+    else {
+      WriteTouchedBlocks(image->mValueImage, os);
+      WriteTouchedBlocks(image->mSquaredImage, os);
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::AddAccumulatorsOfAllImages(const G4String & filename)
+{
+  std::ifstream is(filename, std::ios::in | std::ios::binary);
+  if (!is) GateError("Cannot read the image accumulators in '" << filename << "'");
+  unsigned long n = 0;
+  is.read(reinterpret_cast<char*>(&n), sizeof(n));
+  if (n != mListOfImages.size())
+    GateError("The file '" << filename << "' contains " << n << " images, " << mListOfImages.size() << " were expected");
+  for (auto image : mListOfImages) {
+    long nbEvents = 0;
+    bool normalise = false;
+    is.read(reinterpret_cast<char*>(&nbEvents), sizeof(nbEvents));
+    is.read(reinterpret_cast<char*>(&normalise), sizeof(bool));
+    if (image->mIsSparseImageEnabled) {
+      AddAllocatedBricks(image->mSparseValueImage, is, filename);
+      AddAllocatedBricks(image->mSparseSquaredImage, is, filename);
+    }
+    else {
+      AddTouchedBlocks(image->mValueImage, is, filename);
+      AddTouchedBlocks(image->mSquaredImage, is, filename);
+    }
+    if (nbEvents >= 0) {
+      if (!image->mIsSaved) image->mLastNumberOfEvents = 0;
+      image->mIsSaved = true;
+      image->mLastNormalise = normalise;
+      image->mLastNumberOfEvents += nbEvents;
+    }
+  }
+  if (!is) GateError("Error while reading the image accumulators in '" << filename << "'");
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Save the images filled by AddAccumulatorsOfAllImages (the temporary images
+// are empty, so SaveData only scales the sums and computes the uncertainty).
+int GateImageWithStatistic::SaveAllMergedImages()
+{
+  int n = 0;
+  for (auto image : mListOfImages) {
+    if (!image->mIsSaved) continue;
+    image->SaveData(image->mLastNumberOfEvents, image->mLastNormalise);
+    n++;
+  }
+  return n;
+}
+//-----------------------------------------------------------------------------
+
 #endif /* end #define GATEIMAGEWITHSTATISTIC_CC */
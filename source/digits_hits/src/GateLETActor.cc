@@ -14,10 +14,10 @@
 
 // gate
 #include "GateLETActor.hh"
+#include "GateStoppingPowerTable.hh"
 #include "GateMiscFunctions.hh"
 
 // g4
-#include <G4EmCalculator.hh>
 #include <G4VoxelLimits.hh>
 #include <G4NistManager.hh>
 #include <G4PhysicalConstants.hh>
@@ -51,7 +51,7 @@ GateLETActor::GateLETActor(G4String name, G4int depth):
   
   pMessenger = new GateLETActorMessenger(this);
   GateDebugMessageDec("Actor",4,"GateLETActor() -- end\n");
-  emcalc = new G4EmCalculator;
+  mSetMaterialDefinition = 0;
 }
 //-----------------------------------------------------------------------------
 
@@ -73,7 +73,10 @@ void GateLETActor::Construct() {
   // Find G4_WATER. This it needed here because we will used this
   // material for dedx computation for LETtoWater.
   G4cout << "Build material: " << mSetMaterial << G4endl;
-  G4NistManager::Instance()->FindOrBuildMaterial(mSetMaterial);
+  mSetMaterialDefinition = G4NistManager::Instance()->FindOrBuildMaterial(mSetMaterial);
+  if (!mSetMaterialDefinition) mSetMaterialDefinition = G4Material::GetMaterial(mSetMaterial, false);
+  if (!mSetMaterialDefinition)
+    GateError("The LETActor " << GetObjectName() << " cannot find the material " << mSetMaterial);
 
   // Enable callbacks
   EnableBeginOfRunAction(true);
@@ -293,6 +296,8 @@ void GateLETActor::ResetData() {
 void GateLETActor::BeginOfRunAction(const G4Run * r) {
   GateVActor::BeginOfRunAction(r);
   GateDebugMessage("Actor", 3, "GateLETActor -- Begin of Run\n");
+  // Physics tables may have changed since the previous run
+  GateStoppingPowerTable::GetInstance()->Clear();
   // ResetData(); // Do no reset here !! (when multiple run);
 }
 //-----------------------------------------------------------------------------
@@ -349,23 +354,17 @@ void GateLETActor::UserSteppingActionInVoxel(const int index, const G4Step* step
   double weightedLET =0;
   double normalizationVal = 0;
   
-  G4double dedx = emcalc->ComputeElectronicDEDX(energy, partname, material,mCutVal);
-  //if (mRestrictedLET){
-      //dedx = emcalc->ComputeElectronicDEDX(energy, partname, material,mCutVal);
-  //}
+  GateStoppingPowerTable * stoppingPowers = GateStoppingPowerTable::GetInstance();
+  G4double dedx = stoppingPowers->GetElectronicDEDX(energy, partname, material, mCutVal);
   // SPR to water is unity, but is overwritten if LET to water is enabled
   G4double SPR_ToWater =1.0;
   
   if (mIsLETtoWaterEnabled){
-    G4double dedx_Water = emcalc->ComputeElectronicDEDX(energy, partname->GetParticleName(), mSetMaterial, mCutVal) ;
-    
-    //if (mRestrictedLET){
-        //dedx_Water = emcalc->ComputeElectronicDEDX(energy, partname->GetParticleName(), mSetMaterial, mCutVal) ;
-    //}
-    
-    if ((dedx > 0) && (dedx_Water >0 ))
+    // 0 when dedx or dedx_Water is 0
+    G4double spr = stoppingPowers->GetElectronicDEDXRatio(energy, partname, material, mSetMaterialDefinition, mCutVal);
+    if (spr > 0)
     {
-        SPR_ToWater = dedx_Water/dedx;
+        SPR_ToWater = spr;
         edep *=SPR_ToWater;
         dedx *=SPR_ToWater;
     }
@@ -138,6 +138,7 @@ void GateMultiMaterialThermalActor::Construct()
 
   // initialize ITK heat map from actor energy map
   GateImageDouble *energyMap = dynamic_cast<GateImageDouble *>(&(mAbsorptionImage.GetValueImage()));
+  if (!energyMap) GateError("The actor '" << GetName() << "' does not support sparse images (enableSparseImages)");
   DoubleDuplicatorType::Pointer doubleDuplicatorFilter = DoubleDuplicatorType::New();
   doubleDuplicatorFilter->SetInputImage(ConvertGateToITKImage_double(energyMap));
   doubleDuplicatorFilter->Update();
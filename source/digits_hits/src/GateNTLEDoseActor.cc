@@ -85,6 +85,7 @@ void GateNTLEDoseActor::Construct() {
 
   SetOriginTransformAndFlagToImage(mEdepImage);
   SetOriginTransformAndFlagToImage(mDoseImage);
+  SetOriginTransformAndFlagToImage(mFluxImage);
   SetOriginTransformAndFlagToImage(mLastHitEventImage);
 
   if (mIsEdepSquaredImageEnabled || mIsEdepUncertaintyImageEnabled ||
@@ -67,12 +67,6 @@ void GatePromptGammaTLEActor::Construct()
   //set up and allocate runtime images.
   SetTLEIoH(mImageGamma);
   if (mIsDebugOutputEnabled){
-    //set up and allocate lasthiteventimage
-    SetOriginTransformAndFlagToImage(mLastHitEventImage);
-    mLastHitEventImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
-    mLastHitEventImage.Allocate();
-    mLastHitEventImage.Fill(-1); //does allocate imply Filling with zeroes?
-
     SetTrackIoH(tmptrackl);
     SetTrackIoH(trackl);
     SetTrackIoH(tracklsq);
@@ -97,7 +91,7 @@ void GatePromptGammaTLEActor::ResetData()
   tmptrackl->Reset();
   trackl->Reset();
   tracklsq->Reset();
-  mLastHitEventImage.Fill(-1);
+  mTouchedBins.clear();
 }
 //-----------------------------------------------------------------------------
 
@@ -140,6 +134,22 @@ void GatePromptGammaTLEActor::BeginOfEventAction(const G4Event *e) {
 }
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+// Callback at end of each event: add the track lengths of the event to
+// trackl, tracklsq. Only the (voxel, bin) touched during the event are visited.
+void GatePromptGammaTLEActor::EndOfEventAction(const G4Event *e) {
+  for (auto & b : mTouchedBins) {
+    double tmp = tmptrackl->GetValueDouble(b.first, b.second);
+    if (tmp == 0) continue; // listed twice
+    trackl->AddValueDouble(b.first, b.second, tmp);
+    tracklsq->AddValueDouble(b.first, b.second, tmp*tmp);
+    tmptrackl->SetValueDouble(b.first, b.second, 0);
+  }
+  mTouchedBins.clear();
+  GateVActor::EndOfEventAction(e);
+}
+//-----------------------------------------------------------------------------
+
 //-----------------------------------------------------------------------------
 void GatePromptGammaTLEActor::UserPostTrackActionInVoxel(const int, const G4Track *)
 {
@@ -177,22 +187,12 @@ void GatePromptGammaTLEActor::UserSteppingActionInVoxel(int index, const G4Step
 
   // Post computation TLE + TLE systematic + random variance (for the uncorrelated case, which is wrong).
   if (mIsDebugOutputEnabled) {
-    // compute sameEvent
-    // sameEvent is false the first time some energy is deposited for each primary particle
-    bool sameEvent=true;
-    GateDebugMessage("Actor", 2,  "GatePromptGammaTLEActor -- UserSteppingActionInVoxel: Last event in index = " << mLastHitEventImage.GetValue(index) << G4endl);
-    if (mCurrentEvent != mLastHitEventImage.GetValue(index)) {
-      sameEvent = false;
-      mLastHitEventImage.SetValue(index, mCurrentEvent);
-    }
+    // The (voxel, bin) is listed the first time it is touched in the event,
+    // it is added to trackl, tracklsq in EndOfEventAction
     int protbin = data.GetHEp()->FindFixBin(particle_energy)-1;
-    if (!sameEvent) {
-      //if not, then update trackl,tracklsq from the previous event, and restart tmptrackl.
-      double tmp = tmptrackl->GetValueDouble(index, protbin);
-      trackl->AddValueDouble(index, protbin, tmp);
-      tracklsq->AddValueDouble(index, protbin, tmp*tmp);
-      tmptrackl->SetValueDouble(index, protbin, distance);
-    } else tmptrackl->AddValueDouble(index, protbin, distance);
+    if (tmptrackl->GetValueDouble(index, protbin) == 0)
+      mTouchedBins.push_back(std::make_pair(index, protbin));
+    tmptrackl->AddValueDouble(index, protbin, distance);
   }
 
   // Regular TLE
@@ -281,6 +281,7 @@ void GateReadout::Digitize()
   final_energy = (G4double*)calloc(n_digi,sizeof(G4double));
   final_digi = (GateDigi**)calloc(n_digi,sizeof(GateDigi*));
   final_nb_out_digi = 0;
+  m_outputDigiIndex.clear();
 
 
   // Start loop on input pulses
@@ -305,10 +306,21 @@ void GateReadout::Digitize()
 			  continue;
 		   }
 
-		  // Loop inside the temporary output list to see if we have one digi with same blockID as input
-		  int this_output_digi = 0;
-		  for (this_output_digi=0; this_output_digi<final_nb_out_digi; this_output_digi++)
-			  if (final_digi[this_output_digi]->GetOutputVolumeID().Top(m_depth) == blockID) break;
+		  // Look in the temporary output list for a digi with same blockID as input: found by the
+		  // hash key of the blockID, the whole list is only searched on a key collision
+		  const size_t key = blockID.GetHashKey();
+		  std::unordered_map<size_t, G4int>::const_iterator found = m_outputDigiIndex.find(key);
+		  int this_output_digi = final_nb_out_digi;
+		  if (found != m_outputDigiIndex.end())
+		  {
+			  if (final_digi[found->second]->GetOutputVolumeID().Top(m_depth) == blockID)
+				  this_output_digi = found->second;
+			  else
+				  for (this_output_digi=0; this_output_digi<final_nb_out_digi; this_output_digi++)
+					  if (final_digi[this_output_digi]->GetOutputVolumeID().Top(m_depth) == blockID) break;
+		  }
+		  else
+			  m_outputDigiIndex[key] = final_nb_out_digi;
 
 		  // Case: we found an output digi with same blockID
 		  if ( this_output_digi!=final_nb_out_digi )
@@ -442,7 +454,7 @@ void GateReadout::Digitize()
 // Reset the global position of the pulse with respect to its volumeID that has been changed previously
 void GateReadout::ResetGlobalPos(GateVSystem* system)
 {
-	m_outputDigi->SetGlobalPos(system->ComputeObjectCenter(&(m_outputDigi->m_volumeID)));
+	m_outputDigi->SetGlobalPos(system->ComputeObjectCenter(&(m_outputDigi->GetVolumeID())));
 }
 
 
@@ -112,6 +112,8 @@ void GateSETLEDoseActor::Construct() {
   mDoseFilename = G4String(removeExtension(mSaveFilename))+"-Dose."+G4String(getExtension(mSaveFilename));
   if (mIsDoseImageEnabled)
     {
+      // Origin and storage flags (single precision, sparse) must be set before Allocate
+      SetOriginTransformAndFlagToImage(mDoseImage);
       mDoseImage.EnableSquaredImage(false);
       mDoseImage.EnableUncertaintyImage(mIsDoseUncertaintyImageEnabled);
       mDoseImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
@@ -131,6 +133,8 @@ void GateSETLEDoseActor::Construct() {
   mPrimaryDoseFilename = G4String(removeExtension(mSaveFilename))+"-primaryDose."+G4String(getExtension(mSaveFilename));
   if (mIsPrimaryDoseImageEnabled)
     {
+      // Origin and storage flags (single precision, sparse) must be set before Allocate
+      SetOriginTransformAndFlagToImage(mPrimaryDoseImage);
       mPrimaryDoseImage.EnableSquaredImage(false);
       mPrimaryDoseImage.EnableUncertaintyImage(mIsPrimaryDoseUncertaintyImageEnabled);
       mPrimaryDoseImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
@@ -150,6 +154,8 @@ void GateSETLEDoseActor::Construct() {
   mSecondaryDoseFilename = G4String(removeExtension(mSaveFilename))+"-secondaryDose."+G4String(getExtension(mSaveFilename));
   if (mIsSecondaryDoseImageEnabled)
     {
+      // Origin and storage flags (single precision, sparse) must be set before Allocate
+      SetOriginTransformAndFlagToImage(mSecondaryDoseImage);
       mSecondaryDoseImage.EnableSquaredImage(false);
       mSecondaryDoseImage.EnableUncertaintyImage(mIsSecondaryDoseUncertaintyImageEnabled);
       mSecondaryDoseImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
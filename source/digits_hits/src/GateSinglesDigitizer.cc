@@ -33,6 +33,7 @@ GateSinglesDigitizer::GateSinglesDigitizer( GateDigitizerMgr* itsDigitizerMgr,
   : GateModuleListManager(itsDigitizerMgr,itsDigitizerMgr->GetObjectName() + "/"+ SD->GetName() +"/SinglesDigitizer/" + digitizerUsersName ,"SinglesDigitizer"),
 	m_outputName(digitizerUsersName+"_"+SD->GetName()),
     m_inputName(digitizerUsersName+"_"+SD->GetName()),
+	m_inPlaceChain(false),
 	m_recordFlag(false),
 	m_SD(SD),
 	m_digitizerName(digitizerUsersName)
@@ -181,3 +182,56 @@ void GateSinglesDigitizer::SetOutputCollectionID()
 
 }
 
+
+void GateSinglesDigitizer::RunInPlaceChain()
+{
+	G4DigiManager *fDM = G4DigiManager::GetDMpointer();
+
+	// inCollection: the digis of the chain are the ones of the input collection of the current DM
+	G4bool inCollection = true;
+	m_chainDigis.clear();
+
+	for (size_t i_DM = 0; i_DM<m_DMlist.size(); i_DM++)
+	{
+		GateVDigitizerModule* DM = m_DMlist[i_DM];
+
+		if (DM->IsInPlaceCapable())
+		{
+			if (inCollection)
+			{
+				// The digis are copied once, as a DM would do: the input collection is left unchanged
+				GateDigiCollection* IDC = (GateDigiCollection*) (fDM->GetDigiCollection(DM->GetCollectionID()));
+				if (!IDC)
+					return; // the following DMs would have nothing to do either
+				m_chainDigis.reserve(IDC->entries());
+				for (size_t i=0; i<IDC->entries(); i++)
+					m_chainDigis.push_back(new GateDigi(*(*IDC)[i]));
+				inCollection = false;
+			}
+			DM->DigitizeInPlace(m_chainDigis);
+		}
+		else
+		{
+			if (!inCollection)
+			{
+				// The input collection of this DM is the (not stored) output of the previous one
+				GateDigiCollection* inputCollection = new GateDigiCollection(m_DMlist[i_DM-1]->GetName(), GetOutputName());
+				for (size_t i=0; i<m_chainDigis.size(); i++)
+					inputCollection->insert(m_chainDigis[i]);
+				m_chainDigis.clear();
+				fDM->SetDigiCollection(DM->GetCollectionID(), inputCollection);
+				inCollection = true;
+			}
+			DM->Digitize();
+		}
+	}
+
+	if (!inCollection)
+	{
+		GateDigiCollection* outputCollection = new GateDigiCollection(m_DMlist.back()->GetName(), GetOutputName());
+		for (size_t i=0; i<m_chainDigis.size(); i++)
+			outputCollection->insert(m_chainDigis[i]);
+		m_chainDigis.clear();
+		fDM->SetDigiCollection(m_outputDigiCollectionID, outputCollection);
+	}
+}
@@ -81,6 +81,12 @@ GateSinglesDigitizerMessenger::GateSinglesDigitizerMessenger(GateSinglesDigitize
   SetInputNameCmd->SetGuidance("Set the name of the input collection name");
   SetInputNameCmd->SetParameterName("Name",false);
 
+  cmdName = GetDirectoryName()+"setInPlaceChain";
+  SetInPlaceChainCmd = new G4UIcmdWithABool(cmdName,this);
+  SetInPlaceChainCmd->SetGuidance("Run the digitizer modules in place, without intermediate collections (only the output collection is stored)");
+  SetInPlaceChainCmd->SetParameterName("flag",true);
+  SetInPlaceChainCmd->SetDefaultValue(true);
+
 
 
 
@@ -92,6 +98,7 @@ GateSinglesDigitizerMessenger::GateSinglesDigitizerMessenger(GateSinglesDigitize
 GateSinglesDigitizerMessenger::~GateSinglesDigitizerMessenger()
 {
   delete SetInputNameCmd;
+  delete SetInPlaceChainCmd;
 
 }
 
@@ -103,6 +110,8 @@ void GateSinglesDigitizerMessenger::SetNewValue(G4UIcommand* command,G4String ne
 
   if (command == SetInputNameCmd)
     { m_digitizer->SetInputName(newValue); }
+  else if (command == SetInPlaceChainCmd)
+    { m_digitizer->SetInPlaceChain(SetInPlaceChainCmd->GetNewBoolValue(newValue)); }
   else
     GateListMessenger::SetNewValue(command,newValue);
 }
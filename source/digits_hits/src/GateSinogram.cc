@@ -35,11 +35,16 @@ void GateSinogram::Reset(size_t ringNumber, size_t crystalNumber, size_t radialE
   // Fist clean-up the result of a previous acqisition (if any)
   if (m_data) {
     for (sinoID=0;sinoID<m_sinogramNb;sinoID++) {
-      free(m_data[sinoID]);
+      if (m_data[sinoID]) free(m_data[sinoID]);
     }
     free(m_data);
     m_data=0;
   }
+  if (m_emptySinogram) {
+    free(m_emptySinogram);
+    m_emptySinogram=0;
+  }
+  m_sinoIDTable.clear();
   if (m_randomsNb) {
     free(m_randomsNb);
     m_randomsNb=0;
@@ -64,21 +69,23 @@ void GateSinogram::Reset(size_t ringNumber, size_t crystalNumber, size_t radialE
   }
 
   if (nVerboseLevel > 2) {
-    G4cout << " >> Allocating " << m_sinogramNb << " 2D sinograms of " << m_radialElemNb <<
-              " radial element X " << m_crystalNb/2 << " views each\n";
+    G4cout << " >> Preparing " << m_sinogramNb << " 2D sinograms of " << m_radialElemNb <<
+              " radial element X " << m_crystalNb/2 << " views each (allocated when first filled)\n";
   }
-  // Allocate the data pointer
-  m_data = (SinogramDataType**) malloc( m_sinogramNb * sizeof(SinogramDataType*) );
+  // Allocate the data pointer, the 2D sinograms are allocated by Fill()
+  m_data = (SinogramDataType**) calloc( m_sinogramNb , sizeof(SinogramDataType*) );
   if (!m_data) {
     G4Exception( "GateSinogram::Reset", "Reset", FatalException, "Could not allocate a 2D sinogram set (out of memory?)\n");
   }
-  // Do the allocations for each 2D sinogram
-  for (sinoID=0;sinoID<m_sinogramNb;sinoID++) {
-    m_data[sinoID] = (SinogramDataType*) malloc( BytesPerSinogram() );
-    if (!(m_data[sinoID])) {
-     G4Exception( "GateSinogram::Reset", "Reset", FatalException, "Could not allocate a new 2D sinogram (out of memory?)\n");
-    }
+  m_emptySinogram = (SinogramDataType*) calloc( PixelsPerSinogram() , sizeof(SinogramDataType) );
+  if (!m_emptySinogram) {
+    G4Exception( "GateSinogram::Reset", "Reset", FatalException, "Could not allocate a new 2D sinogram (out of memory?)\n");
   }
+  // 2D sino ID of each pair of rings, looked up by Fill() and FillRandoms()
+  m_sinoIDTable.resize(m_ringNb*m_ringNb);
+  for (size_t ring1ID=0;ring1ID<m_ringNb;ring1ID++)
+    for (size_t ring2ID=0;ring2ID<m_ringNb;ring2ID++)
+      m_sinoIDTable[ring1ID + ring2ID*m_ringNb] = ComputeSinoID(ring1ID,ring2ID);
   // Allocate the randoms pointer
   m_randomsNb = (SinogramDataType*) calloc( m_sinogramNb , sizeof(SinogramDataType) );
   if (!m_randomsNb) G4Exception( "GateSinogram::Reset", "Reset", FatalException, "Could not allocate a new randoms array (out of memory?)\n");
@@ -103,13 +110,12 @@ void GateSinogram::ClearData(size_t frameID, size_t gateID, size_t dataID, size_
               ", data " << m_currentDataID << ", bed " << m_currentBedID << Gateendl;
   }
   for (sinoID=0;sinoID<m_sinogramNb;sinoID++)
-    memset(m_data[sinoID],0, BytesPerSinogram() );
+    if (m_data[sinoID]) memset(m_data[sinoID],0, BytesPerSinogram() );
   memset(m_randomsNb,0,m_sinogramNb * sizeof(SinogramDataType));
 }
 
 G4int GateSinogram::GetSinoID( G4int ring1ID, G4int ring2ID)
 {
-  G4int  DeltaZ,ADeltaZ,sinoID,i;
   // Check that the IDs are valid
   if ( (ring1ID<0) || (ring1ID>=(G4int) m_ringNb) ) {
     G4cerr << "[GateToSinogram::GetSinoID]:\n"
@@ -121,6 +127,12 @@ G4int GateSinogram::GetSinoID( G4int ring1ID, G4int ring2ID)
       	   << "Received a wrong ring-2 ID (" << ring2ID << "): ignored!\n";
     return -2;
   }
+  return m_sinoIDTable[ring1ID + ring2ID*m_ringNb];
+}
+
+G4int GateSinogram::ComputeSinoID( G4int ring1ID, G4int ring2ID) const
+{
+  G4int  DeltaZ,ADeltaZ,sinoID,i;
   // original: sinoID = ring1ID + ring2ID*m_ringNb;
   DeltaZ = ring2ID-ring1ID;
   if (DeltaZ < 0) ADeltaZ = -DeltaZ; else ADeltaZ = DeltaZ;
@@ -131,6 +143,15 @@ G4int GateSinogram::GetSinoID( G4int ring1ID, G4int ring2ID)
   return sinoID;
 }
 
+size_t GateSinogram::GetAllocatedSinogramNb() const
+{
+  size_t nb = 0;
+  if (m_data)
+    for (size_t sinoID=0;sinoID<m_sinogramNb;sinoID++)
+      if (m_data[sinoID]) nb++;
+  return nb;
+}
+
 G4int GateSinogram::FillRandoms( G4int ring1ID, G4int ring2ID)
 {
   G4int sinoID;
@@ -238,6 +259,12 @@ G4int GateSinogram::Fill( G4int ring1ID, G4int ring2ID, G4int crystal1ID, G4int
       G4cout << " >> [GateSinogram::Fill]: binning LOR at (" <<  crystal1ID << "," << ring1ID << ")-(" << crystal2ID  << ","
       << ring2ID << ") into sinogram bin (" << binElemID << "," << binViewID <<
       ") of 2D sinogram (" << ring1ID+ring2ID << "," << ring2ID-ring1ID << ")\n";
+  if (!m_data[sinoID]) {
+    m_data[sinoID] = (SinogramDataType*) calloc( PixelsPerSinogram() , sizeof(SinogramDataType) );
+    if (!(m_data[sinoID])) {
+      G4Exception( "GateSinogram::Fill", "Fill", FatalException, "Could not allocate a new 2D sinogram (out of memory?)\n");
+    }
+  }
   SinogramDataType& dest = m_data[sinoID][ binElemID + binViewID * m_radialElemNb];
 
   if (signe > 0) {
@@ -268,7 +295,7 @@ void GateSinogram::StreamOut(std::ofstream& dest, size_t sinoID, size_t seekID)
     if (sinoID >= m_sinogramNb) G4Exception( "GateSinogram::StreamOut", "StreamOut", FatalException, "SinoID out of range !\n");
     dest.seekp(seekID * BytesPerSinogram(),std::ios::beg);
     if ( dest.bad() ) G4Exception( "GateSinogram::StreamOut", "StreamOut", FatalException, "Could not write a 2D sinogram onto the disk (out of disk space?)!\n");
-    dest.write((const char*)(m_data[sinoID]),BytesPerSinogram() );
+    dest.write((const char*)(GetSinogram(sinoID)),BytesPerSinogram() );
     if ( dest.bad() ) G4Exception( "GateToSinogram:StreamOut", "StreamOut", FatalException, "Could not write a 2D sinogram onto the disk (out of disk space?)!\n");
     dest.flush();
 }
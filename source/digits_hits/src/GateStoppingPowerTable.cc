@@ -0,0 +1,161 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+#include "GateStoppingPowerTable.hh"
+#include "GateMessageManager.hh"
+
+#include <cmath>
+
+#include <G4EmCalculator.hh>
+#include <G4Material.hh>
+#include <G4ParticleDefinition.hh>
+#include <G4SystemOfUnits.hh>
+
+GateStoppingPowerTable * GateStoppingPowerTable::singleton_StoppingPowerTable = 0;
+
+//-----------------------------------------------------------------------------
+GateStoppingPowerTable::GateStoppingPowerTable()
+{
+  mEmCalculator = new G4EmCalculator;
+  mLastTable = 0;
+  // 0.1 keV to 100 GeV, 50 bins per decade. Geant4 itself tabulates the
+  // dedx with a coarser grid, the interpolation error is well below 0.1%.
+  mLogEnergyMin = std::log(0.1*keV);
+  mLogEnergyMax = std::log(100*GeV);
+  mNumberOfBins = 9*50;
+  mInverseLogStep = mNumberOfBins/(mLogEnergyMax - mLogEnergyMin);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GateStoppingPowerTable::~GateStoppingPowerTable()
+{
+  delete mEmCalculator;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateStoppingPowerTable::Clear()
+{
+  mTables.clear();
+  mLastTable = 0;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4double GateStoppingPowerTable::GetTotalDEDX(G4double energy, const G4ParticleDefinition * p,
+                                              const G4Material * material, G4double cut)
+{
+  return GetValue(TotalDEDX, energy, p, material, 0, cut);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4double GateStoppingPowerTable::GetElectronicDEDX(G4double energy, const G4ParticleDefinition * p,
+                                                   const G4Material * material, G4double cut)
+{
+  return GetValue(ElectronicDEDX, energy, p, material, 0, cut);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4double GateStoppingPowerTable::GetTotalDEDXRatio(G4double energy, const G4ParticleDefinition * p,
+                                                   const G4Material * material,
+                                                   const G4Material * reference, G4double cut)
+{
+  return GetValue(TotalDEDX, energy, p, material, reference, cut);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4double GateStoppingPowerTable::GetElectronicDEDXRatio(G4double energy, const G4ParticleDefinition * p,
+                                                        const G4Material * material,
+                                                        const G4Material * reference, G4double cut)
+{
+  return GetValue(ElectronicDEDX, energy, p, material, reference, cut);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4double GateStoppingPowerTable::ComputeDEDX(DEDXType type, G4double energy,
+                                             const G4ParticleDefinition * p,
+                                             const G4Material * material, G4double cut)
+{
+  if (type == TotalDEDX) return mEmCalculator->ComputeTotalDEDX(energy, p, material, cut);
+  return mEmCalculator->ComputeElectronicDEDX(energy, p, material, cut);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4double GateStoppingPowerTable::ComputeValue(DEDXType type, G4double energy,
+                                              const G4ParticleDefinition * p,
+                                              const G4Material * material,
+                                              const G4Material * reference, G4double cut)
+{
+  G4double dedx = ComputeDEDX(type, energy, p, material, cut);
+  if (reference == 0) return dedx;
+  if (dedx == 0) return 0;
+  return ComputeDEDX(type, energy, p, reference, cut)/dedx;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4double GateStoppingPowerTable::GetValue(DEDXType type, G4double energy,
+                                          const G4ParticleDefinition * p,
+                                          const G4Material * material,
+                                          const G4Material * reference, G4double cut)
+{
+  if (energy <= 0) return ComputeValue(type, energy, p, material, reference, cut);
+  G4double x = (std::log(energy) - mLogEnergyMin)*mInverseLogStep;
+  if (x < 0 || x >= mNumberOfBins)
+    return ComputeValue(type, energy, p, material, reference, cut);
+
+  const std::vector<G4double> & table = GetTable(Key(type, p, material, reference, cut));
+  int i = static_cast<int>(x);
+  G4double f = x - i;
+  return table[i] + f*(table[i+1] - table[i]);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+const std::vector<G4double> & GateStoppingPowerTable::GetTable(const Key & key)
+{
+  if (mLastTable && key == mLastKey) return *mLastTable;
+
+  std::map<Key, std::vector<G4double> >::iterator it = mTables.find(key);
+  if (it == mTables.end()) {
+    DEDXType type = static_cast<DEDXType>(std::get<0>(key));
+    const G4ParticleDefinition * p = std::get<1>(key);
+    const G4Material * material = std::get<2>(key);
+    const G4Material * reference = std::get<3>(key);
+    G4double cut = std::get<4>(key);
+    GateMessage("Actor", 3, "Build stopping power table for " << p->GetParticleName()
+                << " in " << material->GetName()
+                << (reference ? " relative to " + reference->GetName() : G4String(""))
+                << Gateendl);
+    std::vector<G4double> table(mNumberOfBins+1);
+    G4double logStep = 1.0/mInverseLogStep;
+    for (int i = 0; i <= mNumberOfBins; i++)
+      table[i] = ComputeValue(type, std::exp(mLogEnergyMin + i*logStep), p, material, reference, cut);
+    it = mTables.insert(std::make_pair(key, table)).first;
+  }
+  mLastKey = key;
+  mLastTable = &(it->second);
+  return *mLastTable;
+}
+//-----------------------------------------------------------------------------
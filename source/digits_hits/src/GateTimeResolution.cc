@@ -116,6 +116,18 @@ void GateTimeResolution::Digitize()
 
 }
 
+
+void GateTimeResolution::DigitizeInPlace(std::vector<GateDigi*>& digis)
+{
+	if (G4EventManager::GetEventManager()->GetNonconstCurrentEvent()->GetEventID() == 0)
+		SetParameters();
+
+	G4double sigma =  m_fwhm / GateConstants::fwhm_to_sigma;
+	for (size_t i=0; i<digis.size(); i++)
+		digis[i]->SetTime(G4RandGauss::shoot(digis[i]->GetTime(), sigma));
+}
+
+
 void GateTimeResolution::SetParameters()
 {
 	if(m_fwhm < 0 ) {
@@ -73,6 +73,11 @@ GateToSinogram::GateToSinogram(const G4String& name, GateOutputMgr* outputMgr,Ga
   // C. Comtat, February 2011: Required to simulate Biograph output sinograms with virtual crystals
   , m_virtualRingPerBlockNb(0)
   , m_virtualCrystalPerBlockNb(0)
+  , m_blockAngularNb(1)
+  , m_crystalTransNb(1)
+  , m_crystalAxialNb(1)
+  , m_axialBlurring(0.)
+  , m_tangBlurring(0.)
 
 {
   m_isEnabled = false; // Keep this flag false: all output are disabled by default
@@ -194,6 +199,15 @@ void GateToSinogram::RecordBeginOfAcquisition()
     G4cout << "    Crystal location blurring in axial direction: " << m_axialCrystalResolution/mm << " mm\n";
   }
 
+  // The block and crystal geometry used to bin each coincidence does not change
+  // during the acquisition: keep it instead of querying the components per event
+  G4ThreeVector crystalPitchVector = crystalComponent->GetRepeatVector();
+  m_blockAngularNb = blockComponent->GetAngularRepeatNumber();
+  m_crystalTransNb = crystalComponent->GetRepeatNumber(1);
+  m_crystalAxialNb = crystalComponent->GetRepeatNumber(2);
+  m_axialBlurring  = m_axialCrystalResolution/crystalPitchVector.z();
+  m_tangBlurring   = m_tangCrystalResolution/crystalPitchVector.y();
+
   // Prepare the sinogram
   m_sinogram->Reset(m_ringNb,m_crystalNb,m_radialElemNb,m_virtualRingPerBlockNb,m_virtualCrystalPerBlockNb);
 
@@ -265,6 +279,8 @@ void GateToSinogram::RecordEndOfRun(const G4Run * r)
     G4cout << "        Number of scattered coincidences for all ring combinations     " << m_nScatter << Gateendl;
     G4cout << "      Number of random coincidences for all ring combinations        " << m_nRandom << Gateendl;
     G4cout << "    Number of delayed coincidences for all ring combinations       " << m_nDelayed << Gateendl;
+    G4cout << "    Number of 2D sinograms filled                                  " << m_sinogram->GetAllocatedSinogramNb()
+           << "/" << m_sinogram->GetSinogramNb() << Gateendl;
   }
 
   // Write the projection sets
@@ -450,10 +466,6 @@ void GateToSinogram::RecordEndOfEvent(const G4Event* )
   if (nVerboseLevel>3) G4cout << " >> entering [GateToSinogram::RecordEndOfEvent] with a digi collection\n";
 
   G4int n_digi =  CDC->entries();
-  // Retrieve the block and the crystal component
-  GateSystemComponent* blockComponent   = m_system->GetMainComponent();
-  GateArrayComponent*  crystalComponent = m_system->GetDetectorComponent();
-  G4ThreeVector        crystalPitchVector = crystalComponent->GetRepeatVector();
 
   if (nVerboseLevel>3) G4cout << " >> Total Digits: " << n_digi << Gateendl;
   for (G4int iDigi=0;iDigi<n_digi;iDigi++) {
@@ -464,15 +476,15 @@ void GateToSinogram::RecordEndOfEvent(const G4Event* )
     G4int crystal1ID = m_system->GetDetectorComponentID( (*CDC)[iDigi]->GetDigi(0) );
     G4int crystal2ID = m_system->GetDetectorComponentID( (*CDC)[iDigi]->GetDigi(1) );
     // crystal ring ID
-    G4int ring1 = (int) (block1ID/blockComponent->GetAngularRepeatNumber())*(crystalComponent->GetRepeatNumber(2)+m_virtualRingPerBlockNb)+
-		  (int)(crystal1ID/crystalComponent->GetRepeatNumber(1));
-    G4int ring2 = (int) (block2ID/blockComponent->GetAngularRepeatNumber())*(crystalComponent->GetRepeatNumber(2)+m_virtualRingPerBlockNb)+
-		  (int)(crystal2ID/crystalComponent->GetRepeatNumber(1));
+    G4int ring1 = (int) (block1ID/m_blockAngularNb)*(m_crystalAxialNb+m_virtualRingPerBlockNb)+
+		  (int)(crystal1ID/m_crystalTransNb);
+    G4int ring2 = (int) (block2ID/m_blockAngularNb)*(m_crystalAxialNb+m_virtualRingPerBlockNb)+
+		  (int)(crystal2ID/m_crystalTransNb);
     // crystal ID within a crystal ring
-    G4int crystal1 = (block1ID % blockComponent->GetAngularRepeatNumber())*(crystalComponent->GetRepeatNumber(1)+m_virtualCrystalPerBlockNb)+
-		     (crystal1ID % crystalComponent->GetRepeatNumber(1));
-    G4int crystal2 = (block2ID % blockComponent->GetAngularRepeatNumber())*(crystalComponent->GetRepeatNumber(1)+m_virtualCrystalPerBlockNb)+
-		     (crystal2ID % crystalComponent->GetRepeatNumber(1));
+    G4int crystal1 = (block1ID % m_blockAngularNb)*(m_crystalTransNb+m_virtualCrystalPerBlockNb)+
+		     (crystal1ID % m_crystalTransNb);
+    G4int crystal2 = (block2ID % m_blockAngularNb)*(m_crystalTransNb+m_virtualCrystalPerBlockNb)+
+		     (crystal2ID % m_crystalTransNb);
     G4int eventID1 = ((*CDC)[iDigi]->GetDigi(0))->GetEventID();
     G4int eventID2 = ((*CDC)[iDigi]->GetDigi(1))->GetEventID();
 
@@ -499,8 +511,8 @@ void GateToSinogram::RecordEndOfEvent(const G4Event* )
     //G4float ypos2 = ((*CDC)[iDigi]->GetDigi(1))->GetGlobalPos().y()/mm;
 
     // offset crystal origin by half-block
-    crystal1 -= crystalComponent->GetRepeatNumber(1)/2;
-    crystal2 -= crystalComponent->GetRepeatNumber(1)/2;
+    crystal1 -= m_crystalTransNb/2;
+    crystal2 -= m_crystalTransNb/2;
     if (crystal1 < 0) crystal1 += m_crystalNb;
     if (crystal2 < 0) crystal2 += m_crystalNb;
 
@@ -543,14 +555,10 @@ void GateToSinogram::RecordEndOfEvent(const G4Event* )
 
     //  Add spatial blurring to crystal IDs
     //G4cout << " DEBUG: gamma one IDs before blurring = " << crystal1 << " ; " << ring1 << Gateendl;
-    m_sinogram->CrystalBlurring(&ring1, &crystal1,
-                                m_axialCrystalResolution/crystalPitchVector.z(),
-				m_tangCrystalResolution/crystalPitchVector.y());
+    m_sinogram->CrystalBlurring(&ring1, &crystal1, m_axialBlurring, m_tangBlurring);
     //G4cout << " DEBUG: gamma one IDs after  blurring = " << crystal1 << " ; " << ring1 << Gateendl;
     //G4cout << " DEBUG: gamma two IDs before blurring = " << crystal2 << " ; " << ring2 << Gateendl;
-    m_sinogram->CrystalBlurring(&ring2, &crystal2,
-                                m_axialCrystalResolution/crystalPitchVector.z(),
-				m_tangCrystalResolution/crystalPitchVector.y());
+    m_sinogram->CrystalBlurring(&ring2, &crystal2, m_axialBlurring, m_tangBlurring);
     //G4cout << " DEBUG: gamma two IDs after  blurring = " << crystal2 << " ; " << ring2 << Gateendl;
 
     //  ordering between detector 1 and detector 2 : x1 >= x2 (convention)
@@ -658,6 +666,7 @@ void GateToSinogram::Describe(size_t indent)
   G4cout << GateTools::Indent(indent) << " >> Number of crystal rings:             " << m_ringNb << Gateendl;
   G4cout << GateTools::Indent(indent) << " >> Number of radial sinogram bins:      " << m_radialElemNb << Gateendl;
   G4cout << GateTools::Indent(indent) << " >> Filled ?                             " << ( m_sinogram->GetData() ? "Yes" : "No" ) << Gateendl;
+  G4cout << GateTools::Indent(indent) << " >> 2D sinograms filled:                 " << m_sinogram->GetAllocatedSinogramNb() << "/" << m_sinogram->GetSinogramNb() << Gateendl;
   G4cout << GateTools::Indent(indent) << " >> Attached to system:                  " << m_system->GetObjectName() << Gateendl;
   G4cout << GateTools::Indent(indent) << " >> Input data:                          " << m_inputDataChannel;
 }
@@ -85,6 +85,26 @@ void GateVDigitizerModule::DescribeMyself(size_t indent)
 
 
 //////////////////
+void GateVDigitizerModule::DigitizeInPlace(std::vector<GateDigi*>& )
+{
+	GateError("[GateVDigitizerModule::DigitizeInPlace] the module " << GetName() << " can not be run in an in-place chain");
+}
+
+
+void GateVDigitizerModule::RemoveRejectedDigis(std::vector<GateDigi*>& digis, const std::vector<G4bool>& keep)
+{
+	size_t n_kept = 0;
+	for (size_t i=0; i<digis.size(); i++)
+	{
+		if (keep[i])
+			digis[n_kept++] = digis[i];
+		else
+			delete digis[i];
+	}
+	digis.resize(n_kept);
+}
+
+
 void GateVDigitizerModule::InputCollectionID()
 {
 	G4cout<<" GateVDigitizerModule::InputCollectionID "<<G4endl;
@@ -223,10 +243,10 @@ GateDigi* GateVDigitizerModule::CentroidMerge(GateDigi* right, GateDigi* output
 {
 
     // AE : Added in a real pulse no sense
-    output->m_Postprocess="NULL";         // PostStep process
+    output->SetPostStepProcess("NULL");         // PostStep process
     output->m_energyIniTrack=-1;         // Initial energy of the track
     output->m_energyFin=-1;         // final energy of the particle
-    output->m_processCreator="NULL";
+    output->SetProcessCreator("NULL");
     output->m_trackID=0;
     //-----------------
 
@@ -267,14 +287,14 @@ GateDigi* GateVDigitizerModule::CentroidMerge(GateDigi* right, GateDigi* output
     if ( right->m_nPhantomCompton > output->m_nPhantomCompton )
     {
         output->m_nPhantomCompton 	= right->m_nPhantomCompton;
-        output->m_comptonVolumeName = right->m_comptonVolumeName;
+        output->m_comptonVolumeNameHandle = right->m_comptonVolumeNameHandle;
     }
 
     // # of Rayleigh process: store the max nb
     if ( right->m_nPhantomRayleigh > output->m_nPhantomRayleigh )
     {
         output->m_nPhantomRayleigh 	= right->m_nPhantomRayleigh;
-        output->m_RayleighVolumeName = right->m_RayleighVolumeName;
+        output->m_RayleighVolumeNameHandle = right->m_RayleighVolumeNameHandle;
     }
 
     // HDS : # of septal hits: store the max nb
@@ -297,10 +317,10 @@ GateDigi* GateVDigitizerModule::MergePositionEnergyWin(GateDigi *right, GateDigi
 
 
     // AE : Added in a real pulse no sense
-    output->m_Postprocess="NULL";         // PostStep process
+    output->SetPostStepProcess("NULL");         // PostStep process
     output->m_energyIniTrack=0;         // Initial energy of the track
     output->m_energyFin=0;         // final energy of the particle
-    output->m_processCreator="NULL";
+    output->SetProcessCreator("NULL");
     output->m_trackID=0;
     //-----------------
 
@@ -335,14 +355,14 @@ GateDigi* GateVDigitizerModule::MergePositionEnergyWin(GateDigi *right, GateDigi
     if ( right->m_nPhantomCompton > output->m_nPhantomCompton )
     {
     	output->m_nPhantomCompton 	= right->m_nPhantomCompton;
-    	output->m_comptonVolumeName = right->m_comptonVolumeName;
+    	output->m_comptonVolumeNameHandle = right->m_comptonVolumeNameHandle;
     }
 
     // # of Rayleigh process: store the max nb
     if ( right->m_nPhantomRayleigh > output->m_nPhantomRayleigh )
     {
     	output->m_nPhantomRayleigh 	= right->m_nPhantomRayleigh;
-    	output->m_RayleighVolumeName = right->m_RayleighVolumeName;
+    	output->m_RayleighVolumeNameHandle = right->m_RayleighVolumeNameHandle;
     }
 
     // HDS : # of septal hits: store the max nb
@@ -16,10 +16,14 @@
 #include "GateVImageVolume.hh"
 #include "GateUtilityForG4ThreeVector.hh"
 
+#include <G4Run.hh>
+#include <G4RunManager.hh>
 #include <G4Step.hh>
 #include <G4TouchableHistory.hh>
 #include <G4VoxelLimits.hh>
 
+#include <algorithm>
+
 
 //-----------------------------------------------------------------------------
 /// Constructor
@@ -34,7 +38,9 @@ GateVImageActor::GateVImageActor(G4String name, G4int depth):
   mVoxelSizeIsSet(false),
   mResolutionIsSet(false),
   mHalfSizeIsSet(false),
-  mPositionIsSet(false)
+  mPositionIsSet(false),
+  mIsSinglePrecisionTempImageEnabled(false),
+  mIsSparseImageEnabled(false)
 {
   GateMessageInc("Actor",4, "GateVImageActor() - begin\n");
   //pMessenger = new GateImageActorMessenger(this);
@@ -234,6 +240,11 @@ void GateVImageActor::SetOriginTransformAndFlagToImage(GateImageWithStatistic &
 
   // Set Overwrite flag
   image.SetOverWriteFilesFlag(mOverWriteFilesFlag);
+
+  image.EnableSinglePrecisionTempImage(mIsSinglePrecisionTempImageEnabled);
+  image.EnableSparseImages(mIsSparseImageEnabled);
+  if (std::find(mListOfImagesWithStatistic.begin(), mListOfImagesWithStatistic.end(), &image) == mListOfImagesWithStatistic.end())
+    mListOfImagesWithStatistic.push_back(&image);
 }
 //-----------------------------------------------------------------------------
 
@@ -247,6 +258,30 @@ void GateVImageActor::SetOriginTransformAndFlagToImage(GateVImage & image)
   // Set transformMatrix
   image.SetTransformMatrix(mImage.GetTransformMatrix());
 
+  if (std::find(mListOfOtherImages.begin(), mListOfOtherImages.end(), &image) == mListOfOtherImages.end())
+    mListOfOtherImages.push_back(&image);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+unsigned long GateVImageActor::GetMemorySize() const
+{
+  unsigned long size = mImage.GetMemorySize();
+  for (auto image : mListOfImagesWithStatistic) size += image->GetMemorySize();
+  for (auto image : mListOfOtherImages) size += image->GetMemorySize();
+  return size;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// SaveData of the images is called one image after the other
+unsigned long GateVImageActor::GetTransientMemorySize() const
+{
+  unsigned long size = 0;
+  for (auto image : mListOfImagesWithStatistic) size = std::max(size, image->GetTransientMemorySize());
+  return size;
 }
 //-----------------------------------------------------------------------------
 
@@ -384,10 +419,97 @@ int GateVImageActor::GetIndexFromTrackPosition(const GateVVolume * v , const G4T
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+// Indices of the current step, shared by all the image actors: actors attached
+// to the same volume with the same grid and hit type reuse the index computed by
+// the first one, and all actors of a volume reuse the positions transformed in
+// the volume frame. Random hit types only reuse the positions: each call draws
+// a new point along the step, so that the actors stay independent and repeated
+// calls (e.g. the step fractions of GateTLFluenceActor) spread along the step.
+namespace {
+  struct StepPositionsInVolume {
+    const GateVVolume * volume;
+    bool found;
+    G4ThreeVector prePosition;
+    G4ThreeVector postPosition;
+  };
+  struct StepIndex {
+    const GateVVolume * volume;
+    G4ThreeVector halfSize;
+    G4ThreeVector voxelSize;
+    G4ThreeVector resolution;
+    bool positionIsSet;
+    G4ThreeVector position;
+    GateVImageActor::StepHitType stepHitType;
+    int index;
+  };
+  G4int sCurrentRunId = -1;
+  G4int sCurrentEventId = -1;
+  G4int sCurrentTrackId = -1;
+  G4int sCurrentStepNumber = -1;
+  std::vector<StepPositionsInVolume> sStepPositions;
+  std::vector<StepIndex> sStepIndices;
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 int GateVImageActor::GetIndexFromStepPosition(const GateVVolume * v, const G4Step * step)
 {
-  return GetIndexFromStepPosition2(v, step, mImage, mPositionIsSet, mPosition, mStepHitType);
+  if(v==0) return -1;
+
+  // A new step (run, event, track and step number) invalidates the cache: event
+  // ids restart at each run, and volumes may have moved between runs
+  const G4Track * track = step->GetTrack();
+  const G4int eventId = GateActorManager::GetInstance()->GetCurrentEventId();
+  const G4Run * run = G4RunManager::GetRunManager()->GetCurrentRun();
+  const G4int runId = run ? run->GetRunID() : -1;
+  if (track->GetCurrentStepNumber() != sCurrentStepNumber ||
+      track->GetTrackID() != sCurrentTrackId ||
+      eventId != sCurrentEventId ||
+      runId != sCurrentRunId) {
+    sCurrentRunId = runId;
+    sCurrentEventId = eventId;
+    sCurrentTrackId = track->GetTrackID();
+    sCurrentStepNumber = track->GetCurrentStepNumber();
+    sStepPositions.clear();
+    sStepIndices.clear();
+  }
+
+  const bool isRandom = (mStepHitType == RandomStepHitType || mStepHitType == RandomStepHitTypeCylindricalCS);
+  const G4ThreeVector & halfSize = mImage.GetHalfSize();
+  const G4ThreeVector & voxelSize = mImage.GetVoxelSize();
+  const G4ThreeVector & resolution = mImage.GetResolution();
+  if (!isRandom) {
+    for (const auto & c : sStepIndices) {
+      if (c.volume == v && c.stepHitType == mStepHitType &&
+          c.halfSize == halfSize && c.voxelSize == voxelSize && c.resolution == resolution &&
+          c.positionIsSet == mPositionIsSet && (!mPositionIsSet || c.position == mPosition))
+        return c.index;
+    }
+  }
+
+  const StepPositionsInVolume * positions = 0;
+  for (const auto & p : sStepPositions) if (p.volume == v) positions = &p;
+  if (positions == 0) {
+    StepPositionsInVolume p;
+    p.volume = v;
+    p.found = GetStepPositionsInVolume(v, step, p.prePosition, p.postPosition);
+    sStepPositions.push_back(p);
+    positions = &sStepPositions.back();
+  }
+
+  int index = -1;
+  if (positions->found)
+    index = GetIndexFromStepPositionsInVolume(positions->prePosition, positions->postPosition,
+                                              mImage, mPositionIsSet, mPosition, mStepHitType, -1.0);
+
+  // A random index is drawn again at each call and is never shared
+  if (isRandom) return index;
+
+  StepIndex c = {v, halfSize, voxelSize, resolution, mPositionIsSet, mPosition, mStepHitType, index};
+  sStepIndices.push_back(c);
+  return index;
 }
 //-----------------------------------------------------------------------------
 
@@ -402,6 +524,22 @@ int GateVImageActor::GetIndexFromStepPosition2(const GateVVolume * v,
 {
   if(v==0) return -1;
 
+  G4ThreeVector prePosition;
+  G4ThreeVector postPosition;
+  if (!GetStepPositionsInVolume(v, step, prePosition, postPosition)) return -1;
+
+  return GetIndexFromStepPositionsInVolume(prePosition, postPosition, image,
+                                           mPositionIsSet, mPosition, mStepHitType, -1.0);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+bool GateVImageActor::GetStepPositionsInVolume(const GateVVolume * v,
+                                               const G4Step * step,
+                                               G4ThreeVector & prePosition,
+                                               G4ThreeVector & postPosition)
+{
   const G4ThreeVector & worldPos = step->GetPostStepPoint()->GetPosition();
   const G4ThreeVector & worldPre =  step->GetPreStepPoint()->GetPosition() ;
 
@@ -425,13 +563,28 @@ int GateVImageActor::GetIndexFromStepPosition2(const GateVVolume * v,
       currentVol = theTouchable->GetVolume(depth)->GetLogicalVolume();
     }
 
-  if(depth>=maxDepth) return -1;
+  if(depth>=maxDepth) return false;
 
   GateDebugMessage("Step",3,"GateVImageActor -- GetIndexFromStepPosition: Logical volume "<<currentVol->GetName() <<" found! - Depth = "<<depth << Gateendl );
 
-  G4ThreeVector postPosition = theTouchable->GetHistory()->GetTransform(transDepth).TransformPoint(worldPos);
-  G4ThreeVector prePosition = theTouchable->GetHistory()->GetTransform(transDepth).TransformPoint(worldPre);
+  postPosition = theTouchable->GetHistory()->GetTransform(transDepth).TransformPoint(worldPos);
+  prePosition = theTouchable->GetHistory()->GetTransform(transDepth).TransformPoint(worldPre);
+  return true;
+}
+//-----------------------------------------------------------------------------
+
 
+//-----------------------------------------------------------------------------
+// 'randomPosition' is the fraction of the step used by the random hit types,
+// drawn here when negative
+int GateVImageActor::GetIndexFromStepPositionsInVolume(G4ThreeVector prePosition,
+                                                       G4ThreeVector postPosition,
+                                                       const GateImage & image,
+                                                       const bool mPositionIsSet,
+                                                       const G4ThreeVector mPosition,
+                                                       const StepHitType mStepHitType,
+                                                       const G4double randomPosition)
+{
   if (mPositionIsSet) {
     GateDebugMessage("Step", 3, "GateVImageActor -- GetIndexFromStepPosition: Step postPosition (vol reference) = " << postPosition << Gateendl);
     GateDebugMessage("Step", 3, "GateVImageActor -- GetIndexFromStepPosition: Step prePosition (vol reference) = " << prePosition << Gateendl);
@@ -464,7 +617,7 @@ int GateVImageActor::GetIndexFromStepPosition2(const GateVVolume * v,
     index = image.GetIndexFromPosition(middle);
   }
   if (mStepHitType == RandomStepHitType) {
-    G4double x = G4UniformRand();
+    G4double x = randomPosition < 0.0 ? G4UniformRand() : randomPosition;
     GateDebugMessage("Step", 4, "GateVImageActor -- GetIndexFromStepPosition:\tx         = " << x << Gateendl);
     G4ThreeVector direction = postPosition-prePosition;
     GateDebugMessageCont("Step", 4, "GateVImageActor -- GetIndexFromStepPosition:\tdirection = " << direction << Gateendl);
@@ -475,7 +628,7 @@ int GateVImageActor::GetIndexFromStepPosition2(const GateVVolume * v,
     index = image.GetIndexFromPosition(position);
   }
  if (mStepHitType == RandomStepHitTypeCylindricalCS) {
-    G4double x = G4UniformRand();
+    G4double x = randomPosition < 0.0 ? G4UniformRand() : randomPosition;
     GateDebugMessage("Step", 4, "GateVImageActor -- GetIndexFromStepPosition:\tx         = " << x << Gateendl);
     G4ThreeVector direction = postPosition-prePosition;
     GateDebugMessageCont("Step", 4, "GateVImageActor -- GetIndexFromStepPosition:\tdirection = " << direction << Gateendl);
@@ -31,6 +31,37 @@
 
 #include <ctime>
 #include <cstring>
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+
+//-----------------------------------------------------------------------------
+namespace {
+  // FNV-1a, used to identify the cached dosel masses
+  void HashBytes(uint64_t & hash, const void * data, size_t size)
+  {
+    const unsigned char * bytes = static_cast<const unsigned char *>(data);
+    for (size_t i=0; i<size; i++) {
+      hash ^= bytes[i];
+      hash *= 1099511628211ULL;
+    }
+  }
+
+  template<class T> void HashValue(uint64_t & hash, const T & value)
+  {
+    HashBytes(hash, &value, sizeof(T));
+  }
+
+  void HashString(uint64_t & hash, const std::string & value)
+  {
+    HashValue(hash, value.size());
+    HashBytes(hash, value.data(), value.size());
+  }
+}
+//-----------------------------------------------------------------------------
 
 
 //-----------------------------------------------------------------------------
@@ -43,8 +74,9 @@ GateVoxelizedMass::GateVoxelizedMass()
   mHasExternalMassImage = false;
   mHasSameResolution    = false;
 
-  mMassFile       = "";
-  mMaterialFilter = "";
+  mMassFile           = "";
+  mMaterialFilter     = "";
+  mMassCacheDirectory = "";
 
   mCubicVolume.clear();
   mMass       .clear();
@@ -153,6 +185,15 @@ void GateVoxelizedMass::Initialize(const G4String _mVolumeName, const GateVImage
     }
   }
 
+  // The mass of all dosels is computed here, GetDoselMass() is then a simple
+  // read in a vector during the tracking.
+  if (doselExternalMass.size() > 0) {
+    doselReconstructedMass = doselExternalMass;
+    mIsVecGenerated = true;
+  }
+  else
+    GenerateVectors();
+
   mIsInitialized=true;
 
   GateMessage("Actor", 10, "[GateVoxelizedMass::" << __FUNCTION__ << "] Ended" << Gateendl);
@@ -179,48 +220,12 @@ bool GateVoxelizedMass::IsLVParameterized(const G4LogicalVolume* LV)
 //-----------------------------------------------------------------------------
 double GateVoxelizedMass::GetDoselMass(const int index)
 {
-  GateMessage("Actor", 10, "[GateVoxelizedMass::" << __FUNCTION__ << "] Started" << Gateendl);
-
-  if (mHasSameResolution) {
-    GateMessage("Actor", 10,  "[GateVoxelizedMass::" << __FUNCTION__ << "] Volume and actor resolution are the same ! I will simply read the mass of the voxel." << Gateendl);
-
-    return theMaterialDatabase.GetMaterial((G4String)imageVolume->GetMaterialNameFromLabel(imageVolume->GetImage()->GetValue(index)))->GetDensity() * imageVolume->GetImage()->GetVoxelVolume();
-  }
-
-  // Case of imported mass image
-  if (mHasExternalMassImage)
-    {
-      if (doselExternalMass.size() > 0.)
-        return doselExternalMass[index];
-      else
-        GateError( "[GateVoxelizedMass::" << __FUNCTION__ << "] ERROR: initialization of doselExternalMass is incorrect !" << Gateendl);
-    }
-
-  if (doselReconstructedMass.size()        == 0) {
-    doselReconstructedMass.clear();
-    doselReconstructedMass.resize(mImage->GetNumberOfValues(),-1.);
+  if (!mIsVecGenerated) {
+    if (mHasExternalMassImage)
+      GateError( "[GateVoxelizedMass::" << __FUNCTION__ << "] ERROR: initialization of doselExternalMass is incorrect !" << Gateendl);
+    GenerateVectors();
   }
 
-  if(doselReconstructedMass[index] < 0.)
-    {
-      GateMessage("Actor", 11,  "[GateVoxelizedMass::" << __FUNCTION__ << "] I don't have the mass of this voxel (index: " << index << ")" << Gateendl);
-
-      if (mIsParameterised)
-        doselReconstructedData = ParameterizedVolume(index);
-      else
-        doselReconstructedData = VoxelIteration(DAPV,
-                                                0,
-                                                DAPV->GetObjectRotationValue(),
-                                                DAPV->GetObjectTranslation(),
-                                                index);
-
-      doselReconstructedMass[index]        = doselReconstructedData.first;
-    }
-
-  GateMessage("Actor", 11,  "[GateVoxelizedMass::" << __FUNCTION__ << "] Computed mass of voxel (index: " << index << "):" << doselReconstructedMass[index] << Gateendl);
-
-  GateMessage("Actor", 10, "[GateVoxelizedMass::" << __FUNCTION__ << "] Ended" << Gateendl);
-
   return doselReconstructedMass[index];
 }
 //-----------------------------------------------------------------------------
@@ -260,45 +265,66 @@ void GateVoxelizedMass::GenerateVectors()
   time_t timer1,timer2,timer3,timer4;
   time(&timer1);
 
-  if (doselReconstructedMass.size() == 0)
-    {
-      doselReconstructedMass.clear();
-      doselReconstructedMass.resize(mImage->GetNumberOfValues(),-1.);
-    }
+  doselReconstructedMass.assign(mImage->GetNumberOfValues(),-1.);
 
   doselReconstructedTotalCubicVolume = 0.;
   doselReconstructedTotalMass        = 0.;
 
-  for(signed long int i=0; i < mImage->GetNumberOfValues(); i++)
-    {
-      time(&timer3);
+  G4String cacheFilename = "";
+  if (mIsParameterised) {
+    GenerateLabelMasses();
+    cacheFilename = GetMassCacheFilename();
+  }
 
-      if(mIsParameterised)
-        doselReconstructedData = ParameterizedVolume(i);
-      else
-        doselReconstructedData = VoxelIteration(DAPV,
-                                                0,
-                                                DAPV->GetObjectRotationValue(),
-                                                DAPV->GetObjectTranslation(),
-                                                i);
+  if (cacheFilename != "" && ReadMassCache(cacheFilename))
+    GateMessage("Actor", 1, "[GateVoxelizedMass::" << __FUNCTION__ << "] Dosel masses read from " << cacheFilename << Gateendl);
+  else if (mIsParameterised && mHasSameResolution)
+    {
+      for(signed long int i=0; i < mImage->GetNumberOfValues(); i++)
+        {
+          const std::pair<double,bool> & labelMass = mLabelMass[imageVoxel->GetValue(i)];
+          doselReconstructedMass[i] = labelMass.second ? labelMass.first : 0.;
+          if (labelMass.second)
+            doselReconstructedTotalCubicVolume += imageVoxel->GetVoxelVolume();
+        }
+    }
+  else if (mIsParameterised)
+    GenerateParameterizedVectors();
+  else
+    {
+      // Boolean solids are built for each dosel: this cannot be done in parallel
+      for(signed long int i=0; i < mImage->GetNumberOfValues(); i++)
+        {
+          time(&timer3);
 
-      doselReconstructedMass[i]        = doselReconstructedData.first;
+          doselReconstructedData = VoxelIteration(DAPV,
+                                                  0,
+                                                  DAPV->GetObjectRotationValue(),
+                                                  DAPV->GetObjectTranslation(),
+                                                  i);
 
-      doselReconstructedTotalMass        += doselReconstructedMass[i];
-      doselReconstructedTotalCubicVolume += doselReconstructedData.second;
+          doselReconstructedMass[i]           = doselReconstructedData.first;
+          doselReconstructedTotalCubicVolume += doselReconstructedData.second;
 
-      time(&timer4);
-      seconds=difftime(timer4,timer1);
+          time(&timer4);
+          seconds=difftime(timer4,timer1);
 
-      if (difftime(timer4,timer1) >= 60 && i%100 == 0)
-        {
-          std::cout<<" "<<i*100/mImage->GetNumberOfValues()<<"% (time elapsed : "<<seconds/60<<"min"<<seconds%60<<"s)      \r"<<std::flush;
-          // Experimental
-          /*seconds=(mImage->GetNumberOfValues()-i)*difftime(timer4,timer3);
-            if(seconds!=0.) std::cout<<"Estimated remaining time : "<<seconds/60<<"min"<<seconds%60<<"s ("<<seconds<<"s)                \r"<<std::flush;*/
+          if (difftime(timer4,timer1) >= 60 && i%100 == 0)
+            {
+              std::cout<<" "<<i*100/mImage->GetNumberOfValues()<<"% (time elapsed : "<<seconds/60<<"min"<<seconds%60<<"s)      \r"<<std::flush;
+              // Experimental
+              /*seconds=(mImage->GetNumberOfValues()-i)*difftime(timer4,timer3);
+                if(seconds!=0.) std::cout<<"Estimated remaining time : "<<seconds/60<<"min"<<seconds%60<<"s ("<<seconds<<"s)                \r"<<std::flush;*/
+            }
         }
     }
 
+  for(size_t i=0; i < doselReconstructedMass.size(); i++)
+    doselReconstructedTotalMass += doselReconstructedMass[i];
+
+  if (cacheFilename != "")
+    WriteMassCache(cacheFilename);
+
   time(&timer2);
   seconds=difftime(timer2,timer1);
 
@@ -321,6 +347,149 @@ void GateVoxelizedMass::GenerateVectors()
 }
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+void GateVoxelizedMass::GenerateLabelMasses()
+{
+  // Material database lookups are done once per label, and not once per
+  // voxel of each dosel. This also makes ParameterizedVolume() thread safe.
+  mLabelMass.clear();
+
+  const GateImage* image = imageVolume->GetImage();
+  const G4double voxelVolume = GetVoxelVolume();
+
+  for (signed long int i=0; i < image->GetNumberOfValues(); i++)
+    {
+      const double label = image->GetValue(i);
+      if (mLabelMass.find(label) != mLabelMass.end())
+        continue;
+
+      const G4String matName = imageVolume->GetMaterialNameFromLabel(label);
+      const G4double mass    = theMaterialDatabase.GetMaterial(matName)->GetDensity() * voxelVolume;
+
+      if (mass <= 0.)
+        {
+          GateError("[GateVoxelizedMass::" << __FUNCTION__ << "] ERROR: Voxel (label: " << label << ", material: " << matName << ") mass is less or equal to zero ! (mass: "<< mass << ")" << Gateendl);
+          exit(EXIT_FAILURE);
+        }
+
+      mLabelMass[label] = std::make_pair(mass, mMaterialFilter == "" || mMaterialFilter == matName);
+    }
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateVoxelizedMass::GenerateParameterizedVectors()
+{
+  const signed long int nbOfDosels = mImage->GetNumberOfValues();
+  const unsigned int nbOfThreads = std::max(1U, std::thread::hardware_concurrency());
+
+  GateMessage("Actor", 1, "[GateVoxelizedMass::" << __FUNCTION__ << "] Dosel masses computed with " << nbOfThreads << " threads" << Gateendl);
+
+  // Dosels are interleaved between threads: neighbouring dosels have similar costs
+  std::vector<double> cubicVolumes(nbOfThreads, 0.);
+  std::vector<std::thread> threads;
+  for (unsigned int t=0; t < nbOfThreads; t++)
+    threads.push_back(std::thread([this, t, nbOfThreads, nbOfDosels, &cubicVolumes]() {
+          for (signed long int i=t; i < nbOfDosels; i+=nbOfThreads)
+            {
+              const pair<double,double> data = ParameterizedVolume(i);
+              doselReconstructedMass[i] = data.first;
+              cubicVolumes[t]          += data.second;
+            }
+        }));
+
+  for (size_t t=0; t < threads.size(); t++)
+    threads[t].join();
+
+  for (size_t t=0; t < cubicVolumes.size(); t++)
+    doselReconstructedTotalCubicVolume += cubicVolumes[t];
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+G4String GateVoxelizedMass::GetMassCacheFilename()
+{
+  if (mMassCacheDirectory == "")
+    return "";
+
+  // Everything the dosel masses depend on: actor grid, voxelized image,
+  // materials of the labels and material filter.
+  uint64_t hash = 14695981039346656037ULL;
+  HashString(hash, "GateVoxelizedMass-1");
+  for (int dim=0; dim < 3; dim++)
+    {
+      HashValue(hash, (double)mImage->GetResolution()[dim]);
+      HashValue(hash, (double)mImage->GetVoxelSize()[dim]);
+      HashValue(hash, (double)mImage->GetVoxelCenterFromIndex(0)[dim]);
+      HashValue(hash, (double)imageVoxel->GetResolution()[dim]);
+      HashValue(hash, (double)imageVoxel->GetVoxelSize()[dim]);
+    }
+  HashValue(hash, (double)DABox->GetXHalfLength());
+  HashValue(hash, (double)DABox->GetYHalfLength());
+  HashValue(hash, (double)DABox->GetZHalfLength());
+  HashString(hash, mMaterialFilter);
+
+  const GateImage* image = imageVolume->GetImage();
+  HashValue(hash, (long)image->GetNumberOfValues());
+  for (signed long int i=0; i < image->GetNumberOfValues(); i++)
+    HashValue(hash, image->GetValue(i));
+
+  for (std::map<double,std::pair<double,bool> >::const_iterator it = mLabelMass.begin(); it != mLabelMass.end(); ++it)
+    {
+      HashValue(hash, it->first);
+      HashValue(hash, it->second.first);
+      HashValue(hash, it->second.second);
+    }
+
+  std::ostringstream filename;
+  filename << mMassCacheDirectory << "/doselMass_" << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+  return filename.str();
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+bool GateVoxelizedMass::ReadMassCache(G4String filename)
+{
+  std::ifstream is(filename, std::ios::binary);
+  if (!is) return false;
+
+  uint64_t n = 0;
+  is.read(reinterpret_cast<char*>(&n), sizeof(n));
+  if (!is || n != doselReconstructedMass.size())
+    {
+      GateWarning("Dosel mass cache " << filename << " does not match the actor, mass is recomputed.");
+      return false;
+    }
+
+  std::vector<double> mass(n);
+  double cubicVolume = 0.;
+  is.read(reinterpret_cast<char*>(mass.data()), n*sizeof(double));
+  is.read(reinterpret_cast<char*>(&cubicVolume), sizeof(double));
+  if (!is)
+    {
+      GateWarning("Dosel mass cache " << filename << " is truncated, mass is recomputed.");
+      return false;
+    }
+
+  doselReconstructedMass.swap(mass);
+  doselReconstructedTotalCubicVolume = cubicVolume;
+  return true;
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateVoxelizedMass::WriteMassCache(G4String filename)
+{
+  std::ofstream os(filename, std::ios::binary);
+  const uint64_t n = doselReconstructedMass.size();
+  os.write(reinterpret_cast<const char*>(&n), sizeof(n));
+  os.write(reinterpret_cast<const char*>(doselReconstructedMass.data()), n*sizeof(double));
+  os.write(reinterpret_cast<const char*>(&doselReconstructedTotalCubicVolume), sizeof(double));
+  if (!os)
+    GateWarning("Cannot write the dosel mass cache " << filename);
+}
+//-----------------------------------------------------------------------------
+
 //-----------------------------------------------------------------------------
 void GateVoxelizedMass::GenerateVoxels()
 {
@@ -475,7 +644,7 @@ G4double GateVoxelizedMass::GetVoxelMass(const unsigned long int x, const unsign
 //-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
-void GateVoxelizedMass::GenerateDosels(const int index)
+void GateVoxelizedMass::GenerateDosels(const int index, std::vector<double> & doselMin, std::vector<double> & doselMax)
 {
   GateMessage("Actor", 10, "[GateVoxelizedMass::" << __FUNCTION__ << "] Started" << Gateendl);
   // INFO : Dimension of the vectors : x = 0, y = 1, z = 2
@@ -525,10 +694,15 @@ pair<double,double> GateVoxelizedMass::ParameterizedVolume(const int index)
 {
   GateMessage("Actor", 10, "[GateVoxelizedMass::" << __FUNCTION__ << "] Started" << Gateendl);
 
-  GenerateDosels(index);
+  // Called concurrently by GenerateParameterizedVectors(): only local
+  // variables and read-only tables are used here.
+  std::vector<double> doselMin, doselMax;
+  GenerateDosels(index, doselMin, doselMax);
 
+  const G4double voxelVolume        = GetVoxelVolume();
+  const GateImage* image            = imageVolume->GetImage();
   G4double doselReconstructedVolume = 0.;
-  doselReconstructedMass[index]     = 0.;
+  G4double doselMass                = 0.;
 
   //GateMessage("Actor", 10, "[GateVoxelizedMass::" << __FUNCTION__ << "] DEBUG: doselMin[0]: " << doselMin[0] << ", doselMax[0]: " << doselMax[0] <<
   //                                                                          ", doselMin[1]: " << doselMin[1] << ", doselMax[1]: " << doselMax[1] <<
@@ -644,39 +818,41 @@ pair<double,double> GateVoxelizedMass::ParameterizedVolume(const int index)
                 {
                   //GateMessage("Actor", 10, "[GateVoxelizedMass::" << __FUNCTION__ << "] DEBUG: coord[0][xVox]: " << coord[0][xVox] << ", coord[1][xVox]: " << coord[1][yVox] << ", coord[2][xVox]: " << coord[2][zVox] << Gateendl);
 
-                  if (mMaterialFilter == "" ||
-                      mMaterialFilter == GetVoxelMatName(coord[0][xVox], coord[1][yVox], coord[2][zVox]))
+                  const std::pair<double,bool> & voxelMass =
+                    mLabelMass.find(image->GetValue(coord[0][xVox], coord[1][yVox], coord[2][zVox]))->second;
+
+                  if (voxelMass.second)
                     {
                       const double coefVox(coef[0][xVox] * coef[1][yVox] * coef[2][zVox]);
 
-                      doselReconstructedVolume      += GetVoxelVolume() * coefVox;
-                      doselReconstructedMass[index] += GetVoxelMass(coord[0][xVox], coord[1][yVox], coord[2][zVox]) * coefVox;
+                      doselReconstructedVolume += voxelVolume * coefVox;
+                      doselMass                += voxelMass.first * coefVox;
 
                       if(doselReconstructedVolume < 0.)
                         GateError("[GateVoxelizedMass::" << __FUNCTION__ << "] ERROR : doselReconstructedVolume is negative !" << Gateendl
                                   <<"     More informations :" << Gateendl
                                   <<"            doselReconstructedVolume=" << doselReconstructedVolume << Gateendl
-                                  <<"            Voxel Volume: " << GetVoxelVolume() << Gateendl
+                                  <<"            Voxel Volume: " << voxelVolume << Gateendl
                                   <<"            coefVox=" << coefVox <<Gateendl);
 
-                      if(doselReconstructedMass[index] < 0.)
+                      if(doselMass < 0.)
                         GateError("[GateVoxelizedMass::" << __FUNCTION__ << "] ERROR : doselReconstructedMass is negative !" << Gateendl
                                   <<"     More informations:" << Gateendl
-                                  <<"            doselReconstructedMass[" << index << "]=" << doselReconstructedMass[index] << Gateendl
-                                  <<"            Voxel Mass: " << GetVoxelMass(coord[0][xVox], coord[1][yVox], coord[2][zVox]) << Gateendl
+                                  <<"            doselReconstructedMass[" << index << "]=" << doselMass << Gateendl
+                                  <<"            Voxel Mass: " << voxelMass.first << Gateendl
                                   <<"            coefVox= " << coefVox << Gateendl);
                     }
                 }
         }
 
-  if(doselReconstructedMass[index] < 0.)
-    GateError("[GateVoxelizedMass::" << __FUNCTION__ << "] ERROR: doselReconstructedMass is negative ! (doselReconstructedMass["<<index<<"] = "<<doselReconstructedMass[index]<<")"<<Gateendl);
+  if(doselMass < 0.)
+    GateError("[GateVoxelizedMass::" << __FUNCTION__ << "] ERROR: doselReconstructedMass is negative ! (doselReconstructedMass["<<index<<"] = "<<doselMass<<")"<<Gateendl);
   if(doselReconstructedVolume < 0.)
     GateError("[GateVoxelizedMass::" << __FUNCTION__ << "] ERROR: doselReconstructedVolume is negative ! (doselReconstructedVolume = "<<doselReconstructedVolume<<")"<<Gateendl);
 
   GateMessage("Actor", 10, "[GateVoxelizedMass::" << __FUNCTION__ << "] Ended" << Gateendl);
 
-  return std::make_pair(doselReconstructedMass[index],doselReconstructedVolume);
+  return std::make_pair(doselMass,doselReconstructedVolume);
 }
 //-----------------------------------------------------------------------------
 
@@ -1153,6 +1329,14 @@ void GateVoxelizedMass::SetExternalMassImage(G4String extMassFile)
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateVoxelizedMass::SetMassCacheDirectory(G4String directory)
+{
+  mMassCacheDirectory = directory;
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 GateImage* Copy(GateImage* oldImage)
 {
@@ -0,0 +1,84 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+
+#ifndef GateAliasTable_h
+#define GateAliasTable_h 1
+
+#include "globals.hh"
+#include "Randomize.hh"
+#include <functional>
+#include <vector>
+
+/*! \class  GateAliasTable
+    \brief  Draws an index with a probability proportional to its weight in constant time
+
+    - Walker's alias method, built with Vose's algorithm: each bin holds one entry, the
+      probability to keep it and the alias returned otherwise. A draw costs one random
+      number and one bin, whatever the number of entries.
+
+    - Only the entries with a positive weight get a bin, so a sparse distribution (most
+      voxels of an activity image are empty) only costs 16 bytes per non-zero entry.
+
+    - The entries are read by chunks of fixed size, in several threads for large
+      distributions. The table does not depend on the number of threads.
+*/
+class GateAliasTable
+{
+  public:
+    GateAliasTable();
+    ~GateAliasTable() {}
+
+    //! Builds the table from the weights of the entries 0 to n-1 (entries with weight <= 0 are never drawn)
+    template<class WeightType>
+    void Build(const WeightType* weights, size_t n);
+    template<class WeightType>
+    inline void Build(const std::vector<WeightType>& weights)
+      { Build(weights.data(), weights.size()); }
+
+    //! Releases the table
+    void Clear();
+
+    //! Returns an entry drawn from u, uniform in [0,1)
+    inline G4int Sample(G4double u) const
+    {
+      const G4double x = u * m_probability.size();
+      size_t bin = static_cast<size_t>(x);
+      if (bin >= m_probability.size()) bin = m_probability.size()-1;
+      return (x - bin < m_probability[bin]) ? m_index[bin] : m_alias[bin];
+    }
+    //! Returns an entry drawn with the current random engine
+    inline G4int Sample() const { return Sample(G4UniformRand()); }
+
+    //! Sum of the positive weights
+    inline G4double GetTotalWeight() const { return m_totalWeight; }
+    //! Number of entries with a positive weight
+    inline size_t GetNumberOfBins() const { return m_probability.size(); }
+    inline G4bool IsEmpty() const { return m_probability.empty(); }
+    //! Memory used by the table (in bytes)
+    unsigned long GetMemorySize() const;
+
+  private:
+    //! Number of entries read at once by a thread
+    static const size_t ChunkSize = 1 << 20;
+
+    //! Runs work(c) for each chunk c, in several threads if there are several chunks
+    static void ForEachChunk(size_t nbOfChunks, const std::function<void(size_t)>& work);
+
+    //! Sets the aliases, m_probability holds the weights scaled to a mean of 1
+    void PairBins();
+
+    std::vector<G4double> m_probability;  // probability to keep the entry of the bin
+    std::vector<G4int>    m_index;        // entry of the bin
+    std::vector<G4int>    m_alias;        // entry returned when the entry of the bin is not kept
+    G4double              m_totalWeight;
+};
+
+#include "GateAliasTable.icc"
+
+#endif
@@ -81,6 +81,11 @@ public:
   void EnableTimeStudyForSteps(G4String filename);
   long GetRequestedAmountOfPrimariesPerRun() { return mRequestedAmountOfPrimariesPerRun; }
 
+  void SetNumberOfProcesses(G4int n) { mNumberOfProcesses = n; }
+  G4int GetNumberOfProcesses() { return mNumberOfProcesses; }
+  //! Index of the current forked process, -1 in the parent (or without forked processes)
+  G4int GetProcessIndex() { return mProcessIndex; }
+
 protected:
 
   GateApplicationMgr();
@@ -116,6 +121,15 @@ protected:
 
   void InitializeTimeSlices();
 
+  G4int mNumberOfProcesses;
+  G4int mProcessIndex;
+  std::vector<int> mProcessIds;
+  G4String GetProcessDirectory(G4int processIndex);
+  bool StartProcesses();
+  void SplitPrimariesBetweenProcesses();
+  void StopProcess();
+  void MergeProcesses();
+
   GateApplicationMgrMessenger* m_appMgrMessenger;
 
 };
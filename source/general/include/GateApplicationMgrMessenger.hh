@@ -63,6 +63,7 @@ private:
 
 //LSLS
   G4UIcmdWithAString *      ReadNumberOfPrimariesInAFileCmd;
+  G4UIcmdWithAnInteger *    SetNumberOfProcessesCmd;
 
 };
 
@@ -57,6 +57,12 @@ public:
   /// Allocates the data
   virtual void Allocate();
 
+  /// Releases the data (the image can be allocated again)
+  void Deallocate() { std::vector<PixelType>().swap(data); }
+
+  /// Returns the memory used by the data (in bytes)
+  virtual unsigned long GetMemorySize() const { return data.capacity()*sizeof(PixelType); }
+
   // Access to the image values
   /// Returns the value of the image at voxel of index provided
   inline PixelType GetValue(int index) const { return data[index]; }
@@ -53,6 +53,11 @@ See LICENSE.md for further details
 
   which tells the manager to display all Core messages of level up to 5.
 
+  Each macro call site interns its type once into an integer handle
+  (GetMessageTypeHandle), then only reads the level of the handle in a
+  table. Messages of a level above GATE_MAX_MESSAGE_LEVEL (cmake option)
+  are not compiled.
+
   Variants :
   Gate*Cont : continues a previous GateMessage on the same line (without rewriting the type and level)
   Gate*Inc / Dec : displays the message and then increments/decrement the messages tabulation
@@ -78,6 +83,7 @@ See LICENSE.md for further details
 
 #include <string>
 #include <map>
+#include <vector>
 #include <iostream>
 #include <sstream>
 #include "G4ExceptionHandler.hh"
@@ -123,14 +129,23 @@ See LICENSE.md for further details
 //-----------------------------------------------------------
 
 //-----------------------------------------------------------
+#ifndef GATE_MAX_MESSAGE_LEVEL
+#define GATE_MAX_MESSAGE_LEVEL 99
+#endif
+
+//-----------------------------------------------------------
+// The handle of the message type is looked up once per call site
 #define GateOnMessageLevel(key,value)			\
+  static const int __GateMessageTypeHandle =		\
+    GateMessageManager::GetMessageTypeHandle(key);	\
   int __GateOnMessageLevelVariable =			\
-    GateMessageManager::GetMessageLevel(key);		\
+    GateMessageManager::GetMessageLevel(__GateMessageTypeHandle); \
   if ( __GateOnMessageLevelVariable<0)			\
     {							\
       GateWarning("message type '"<<key<<"' unknown");	\
     }							\
-  else if (value<= __GateOnMessageLevelVariable)
+  else if ((value) <= GATE_MAX_MESSAGE_LEVEL &&		\
+           (value) <= __GateOnMessageLevelVariable)
 
 //-----------------------------------------------------------
 #ifdef GATE_PREPEND_MESSAGE_WITH_CODE
@@ -358,7 +373,9 @@ See LICENSE.md for further details
 #define GateWarning(MESSAGE)						\
   do									\
     {									\
-      int lev = GateMessageManager::GetMessageLevel("Warning");		\
+      static const int __GateWarningHandle =				\
+        GateMessageManager::GetMessageTypeHandle("Warning");		\
+      int lev = GateMessageManager::GetMessageLevel(__GateWarningHandle); \
       if (lev >0)							\
 	{								\
 	  std::cout << " <!> *** WARNING *** <!>  " << MESSAGE << Gateendl; \
@@ -447,6 +464,11 @@ public:
 				  unsigned char default_level = 9);
   static void SetMessageLevel(std::string key, unsigned char level);
   static int GetMessageLevel(std::string key);
+  /// Integer handle of a message type (types not registered yet get one too)
+  static int GetMessageTypeHandle(const std::string & key);
+  /// Level of the messages of a handle, a single table read
+  static int GetMessageLevel(int handle) { return mEffectiveLevel[handle]; }
+  static const int MaxNumberOfMessageTypes = 256;
   static std::string& GetTab() { static std::string s; return s; }
   static std::string GetSpace(int n);
   static void IncTab() { GetTab() += std::string("   "); }
@@ -469,6 +491,12 @@ protected:
   unsigned int mMaxMessageLength;
   int mAllLevel;
   int mEnableG4Message;
+
+  // Message types by handle, and their level (max of own level and "All")
+  std::map<std::string,int> mMessageTypeHandle;
+  std::vector<std::string> mMessageTypeKey;
+  static int mEffectiveLevel[MaxNumberOfMessageTypes];
+  void UpdateEffectiveLevels();
 };
 //-----------------------------------------------------------
 
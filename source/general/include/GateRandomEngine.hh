@@ -35,6 +35,11 @@ public:
   void resetEngineFrom(const G4String& file); //TC
   void ShowStatus();
   void Initialize();
+  //! Give forked process 'processIndex' its own seed, drawn from the initialised engine
+  void InitializeForProcess(G4int processIndex, G4int numberOfProcesses);
+  //! Creates an engine for an independent stream of random numbers. Its seed only depends on
+  //! the seed of the main engine and on the stream name (the caller owns the engine)
+  CLHEP::HepRandomEngine* CreateStreamEngine(const G4String& streamName) const;
 
 private:
   // Private constructor because the class is a singleton
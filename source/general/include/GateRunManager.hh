@@ -20,6 +20,10 @@
   - RunInitialisation(): overload of G4RunManager()::RunInitialisation() that resets the geometry
   navigator.
 
+  - GateRunManager is always a sequential run manager, even when Geant4 is built
+  multithreaded: actors, sources, outputs and digitizers are shared singletons and
+  cannot be cloned per worker thread.
+
   \sa GateSystemComponent, GateBoxCreatorComponent, GateArrayRepeater
 */
 
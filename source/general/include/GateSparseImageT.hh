@@ -0,0 +1,139 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+/*!
+  \class GateSparseImageT
+  \ingroup data_structures
+
+  3D image stored as bricks of BrickEdge^3 voxels, a brick is allocated
+  the first time one of its voxels gets a value different from the
+  background value. Used for large scoring grids where most of the voxels
+  stay empty (whole body or out-of-field dosimetry). The voxel indices
+  are the same as the ones of GateImageT. MHD files are written slice by
+  slice without building the dense image; the other formats are written
+  through a temporary dense GateImageT.
+*/
+
+#ifndef __GATESPARSEIMAGET_HH__
+#define __GATESPARSEIMAGET_HH__
+
+// std
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// gate
+#include "GateVImage.hh"
+#include "GateImageT.hh"
+
+/// \brief Block-sparse 3D images of PixelType values
+template<class PixelType>
+class GateSparseImageT : public GateVImage
+{
+public:
+
+  GateSparseImageT();
+  virtual ~GateSparseImageT();
+
+  /// Number of voxels along each edge of a brick (BrickEdge = 1 << BrickShift)
+  static constexpr int BrickShift = 3;
+  static constexpr int BrickEdge = 1 << BrickShift;
+  static constexpr int BrickVolume = BrickEdge*BrickEdge*BrickEdge;
+
+  /// Allocates the table of bricks (all bricks are empty)
+  virtual void Allocate();
+
+  /// Releases the bricks and the table (the image can be allocated again)
+  void Deallocate();
+
+  /// Returns the memory used by the table and the allocated bricks (in bytes)
+  virtual unsigned long GetMemorySize() const;
+
+  /// Returns the value of the voxel of index provided
+  inline PixelType GetValue(int index) const {
+    int offset;
+    const PixelType * brick = mBricks[GetBrickIndex(index, offset)].get();
+    return brick ? brick[offset] : mBackgroundValue;
+  }
+
+  /// Sets the value of the voxel of index provided
+  inline void SetValue(int index, PixelType value) {
+    int offset;
+    unsigned long b = GetBrickIndex(index, offset);
+    if (!mBricks[b]) {
+      if (value == mBackgroundValue) return;
+      AllocateBrick(b);
+    }
+    mBricks[b][offset] = value;
+  }
+
+  /// Adds a value to the voxel of index provided
+  inline void AddValue(int index, PixelType value) {
+    if (value == 0) return;
+    int offset;
+    unsigned long b = GetBrickIndex(index, offset);
+    if (!mBricks[b]) AllocateBrick(b);
+    mBricks[b][offset] += value;
+  }
+
+  /// Sets all voxels to a value (releases all bricks)
+  void Fill(PixelType value);
+
+  /// Value of the voxels of the bricks that are not allocated
+  PixelType GetBackgroundValue() const { return mBackgroundValue; }
+
+  // Access to the bricks, for operations on the whole image
+  unsigned long GetNumberOfBricks() const { return mBricks.size(); }
+  unsigned long GetNumberOfAllocatedBricks() const { return mNumberOfAllocatedBricks; }
+  /// Returns the voxels of the brick, 0 if it is not allocated
+  const PixelType * GetBrick(unsigned long b) const { return mBricks[b].get(); }
+  PixelType * GetBrick(unsigned long b) { return mBricks[b].get(); }
+  PixelType * GetOrAllocateBrick(unsigned long b);
+
+  /// Copies the voxels in a dense image (allocated here, same geometry)
+  void CopyTo(GateImageT<PixelType> & image) const;
+
+  // IO
+  /// Writes the image to a file (the format is detected automatically)
+  virtual void Write(G4String filename, const G4String & comment = "");
+
+  /// Reads the image from a file (the format is detected automatically)
+  virtual void Read(G4String filename);
+
+  /// Displays info about the image to standard output
+  virtual void PrintInfo();
+
+  //-----------------------------------------------------------------------------
+protected:
+  std::vector<std::unique_ptr<PixelType[]> > mBricks;
+  PixelType mBackgroundValue;
+  unsigned long mNumberOfAllocatedBricks;
+  int mNumberOfBricksX;
+  int mNumberOfBricksY;
+  int mNumberOfBricksZ;
+
+  /// Returns the brick of the voxel and the offset of the voxel in the brick
+  inline unsigned long GetBrickIndex(int index, int & offset) const {
+    const int k = index / planeSize;
+    const int r = index - k*planeSize;
+    const int j = r / lineSize;
+    const int i = r - j*lineSize;
+    offset = (i & (BrickEdge-1)) + ((j & (BrickEdge-1)) << BrickShift) + ((k & (BrickEdge-1)) << (2*BrickShift));
+    return (i >> BrickShift) + mNumberOfBricksX*((j >> BrickShift) + mNumberOfBricksY*(k >> BrickShift));
+  }
+
+  void AllocateBrick(unsigned long b);
+  void WriteMHD(std::string filename);
+};
+
+typedef GateSparseImageT<double> GateSparseImageDouble;
+
+#include "GateSparseImageT.icc"
+
+#endif
@@ -0,0 +1,58 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+
+#ifndef GateStringTable_h
+#define GateStringTable_h 1
+
+#include "globals.hh"
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+/*! \class  GateStringTable
+    \brief  Stores each string once, objects created in large numbers (hits, digis) only keep an integer handle
+
+    - The GateStringTable is a singleton. It is meant for the small set of names
+      (process names, volume names...) that are repeated in every hit, so it never
+      removes a string.
+
+    - Handle 0 is the empty string. The references returned by GetString() stay
+      valid for the whole simulation.
+*/
+class GateStringTable
+{
+  public:
+    //! Returns the GateStringTable singleton (created on first call)
+    static GateStringTable* GetInstance();
+
+    ~GateStringTable() {}
+
+  private:
+    GateStringTable();   //!< Private constructor: this function should only be called from GetInstance()
+
+  public:
+    //! Returns the handle of a string (stored if not yet known)
+    G4int GetHandle(const G4String& aString);
+
+    //! Returns the string of a handle
+    inline const G4String& GetString(G4int handle) const
+      { return m_strings[handle]; }
+
+    //! Number of strings stored (including the empty one)
+    inline size_t GetNumberOfStrings() const { return m_strings.size(); }
+
+  private:
+    std::deque<G4String>                  m_strings;   // deque: the references stay valid when the table grows
+    std::unordered_map<std::string,G4int> m_handles;
+
+    //! Static pointer to the GateStringTable singleton
+    static GateStringTable* pInstance;
+};
+
+#endif
@@ -54,6 +54,9 @@ public:
   /// Allocates the data
   virtual void Allocate() = 0;
 
+  /// Returns the memory used by the data (in bytes)
+  virtual unsigned long GetMemorySize() const = 0;
+
   /// Returns the size of the image
   inline G4ThreeVector GetSize()           const { return size; }
 
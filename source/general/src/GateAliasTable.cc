@@ -0,0 +1,92 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+
+#include "GateAliasTable.hh"
+
+#include <thread>
+
+
+//-----------------------------------------------------------------------------------
+GateAliasTable::GateAliasTable()
+  : m_totalWeight(0.)
+{
+}
+//-----------------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------------
+void GateAliasTable::Clear()
+{
+  std::vector<G4double>().swap(m_probability);
+  std::vector<G4int>().swap(m_index);
+  std::vector<G4int>().swap(m_alias);
+  m_totalWeight = 0.;
+}
+//-----------------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------------
+unsigned long GateAliasTable::GetMemorySize() const
+{
+  return m_probability.capacity()*sizeof(G4double) + (m_index.capacity()+m_alias.capacity())*sizeof(G4int);
+}
+//-----------------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------------
+void GateAliasTable::ForEachChunk(size_t nbOfChunks, const std::function<void(size_t)>& work)
+{
+  const size_t nbOfThreads = std::min<size_t>(nbOfChunks, std::max(1U, std::thread::hardware_concurrency()));
+  if (nbOfThreads <= 1) {
+    for (size_t c=0; c<nbOfChunks; c++)
+      work(c);
+    return;
+  }
+
+  // Chunks are interleaved between threads, each chunk is written by one thread only
+  std::vector<std::thread> threads;
+  for (size_t t=0; t<nbOfThreads; t++)
+    threads.push_back(std::thread([t, nbOfThreads, nbOfChunks, &work]() {
+          for (size_t c=t; c<nbOfChunks; c+=nbOfThreads)
+            work(c);
+        }));
+  for (size_t t=0; t<threads.size(); t++)
+    threads[t].join();
+}
+//-----------------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------------
+// Vose: a bin below 1 is completed by a bin above 1, which gives it the missing
+// probability and becomes its alias, until all bins are at 1
+void GateAliasTable::PairBins()
+{
+  std::vector<G4int> small, large;
+  for (size_t bin=0; bin<m_probability.size(); bin++)
+    (m_probability[bin] < 1. ? small : large).push_back(bin);
+
+  while (!small.empty() && !large.empty()) {
+    const G4int s = small.back();
+    const G4int l = large.back();
+    small.pop_back();
+    m_alias[s] = m_index[l];
+    m_probability[l] -= 1. - m_probability[s];
+    if (m_probability[l] < 1.) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+
+  // Left-overs are at 1 up to rounding errors
+  for (size_t i=0; i<large.size(); i++)
+    m_probability[large[i]] = 1.;
+  for (size_t i=0; i<small.size(); i++)
+    m_probability[small[i]] = 1.;
+}
+//-----------------------------------------------------------------------------------
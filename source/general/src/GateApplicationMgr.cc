@@ -21,14 +21,27 @@
 #include "GateVSource.hh"
 #include "GateSourceMgr.hh"
 #include "GateOutputMgr.hh"
+#include "GateVOutputModule.hh"
+#include "GateActorManager.hh"
+#include "GateVActor.hh"
+#include "GateImageWithStatistic.hh"
 #include <algorithm> /* min and max */
+#include <filesystem>
+#include <map>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#ifdef G4ANALYSIS_USE_ROOT
+#include "TFileMerger.h"
+#endif
 
 GateApplicationMgr* GateApplicationMgr::instance = 0;
 //------------------------------------------------------------------------------------------
 GateApplicationMgr::GateApplicationMgr():
   nVerboseLevel(0), m_time(0),
   mOutputMode(true),  mTimeSliceIsSetUsingAddSlice(false), mTimeSliceIsSetUsingReadSliceInFile(false),
-  mTimeStepInTotalAmountOfPrimariesMode(0.0)
+  mTimeStepInTotalAmountOfPrimariesMode(0.0),
+  mNumberOfProcesses(1), mProcessIndex(-1)
 {
   if(instance != 0) // this function is only ever called if instance==0. This will never be true...
     G4Exception( "GateApplicationMgr::GateApplicationMgr", "GateApplicationMgr", FatalException, "GateApplicationMgr constructed twice.");
@@ -355,6 +368,12 @@ void GateApplicationMgr::StartDAQ()
   theRandomEngine->Initialize();
   if (theRandomEngine->GetVerbosity()>=1) theRandomEngine->ShowStatus();
 
+  // With several processes, the parent only waits for the forked ones and merges their outputs
+  if (mNumberOfProcesses > 1 && !StartProcesses()) {
+    MergeProcesses();
+    return;
+  }
+
   GateClock* theClock = GateClock::GetInstance();
 
   m_clusterStart = mTimeSlices.front();
@@ -424,6 +443,7 @@ void GateApplicationMgr::StartDAQ()
   for(int nsource= 0 ; nsource<GateSourceMgr::GetInstance()->GetNumberOfSources() ; nsource++ )
     GateMessage("Acquisition", 1, "Source "<<nsource+1<<" --> Number of events = "<<GateSourceMgr::GetInstance()->GetNumberOfEventBySource(nsource+1)<< Gateendl);
 
+  if (mProcessIndex >= 0) StopProcess();
 }
 //------------------------------------------------------------------------------------------
 
@@ -539,6 +559,154 @@ void GateApplicationMgr::StartDAQCluster(G4ThreeVector param)
 //------------------------------------------------------------------------------------------
 
 
+//------------------------------------------------------------------------------------------
+G4String GateApplicationMgr::GetProcessDirectory(G4int processIndex)
+{
+  return "gate_process_" + std::to_string(processIndex);
+}
+//------------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------------
+// Fork the processes once geometry, physics and sources are initialised, so
+// that they share these read-only pages copy-on-write. Each process runs in
+// its own directory: all relative output filenames are written there. Return
+// true in the forked processes, false in the parent.
+bool GateApplicationMgr::StartProcesses()
+{
+  if (!mATotalAmountOfPrimariesIsRequested && !mReadNumberOfPrimariesInAFileIsUsed) {
+    GateError("setNumberOfProcesses requires a number of primaries: use setTotalNumberOfPrimaries, "
+              << "setNumberOfPrimariesPerRun or readNumberOfPrimariesInAFile");
+  }
+  if (mATotalAmountOfPrimariesIsRequested && !mAnAmountOfPrimariesPerRunIsRequested
+      && mRequestedAmountOfPrimaries < mNumberOfProcesses) {
+    GateError("The total number of primaries (" << mRequestedAmountOfPrimaries
+              << ") is lower than the number of processes (" << mNumberOfProcesses << ")");
+  }
+
+  // Output filenames of the actors and of the enabled output modules (those
+  // without filename return blank names)
+  std::vector<std::string> outputs;
+  for (auto actor : GateActorManager::GetInstance()->GetTheListOfActors())
+    outputs.push_back(actor->GetSaveFilename());
+  for (auto module : GateOutputMgr::GetInstance()->m_outputModules)
+    if (module->IsEnabled() && module->GiveNameOfFile().find_first_not_of(' ') != std::string::npos)
+      outputs.push_back(module->GiveNameOfFile());
+
+  for (G4int p=0; p<mNumberOfProcesses; p++) {
+    std::filesystem::path dir(GetProcessDirectory(p));
+    std::filesystem::create_directories(dir);
+    for (auto & f : outputs) {
+      std::filesystem::path path(f);
+      if (path.is_absolute())
+        GateError("setNumberOfProcesses requires relative output filenames, but '" << f << "' is absolute");
+      if (path.has_parent_path()) std::filesystem::create_directories(dir / path.parent_path());
+    }
+  }
+
+  GateMessage("Acquisition", 0, "Acquisition is split between " << mNumberOfProcesses << " processes\n");
+  G4cout << std::flush;
+  std::cout << std::flush;
+  std::cerr << std::flush;
+
+  for (G4int p=0; p<mNumberOfProcesses; p++) {
+    pid_t pid = fork();
+    if (pid < 0) GateError("Cannot fork process " << p);
+    if (pid == 0) {
+      mProcessIndex = p;
+      if (chdir(GetProcessDirectory(p).c_str()) != 0)
+        GateError("Cannot change to directory '" << GetProcessDirectory(p) << "'");
+      GateRandomEngine::GetInstance()->InitializeForProcess(mProcessIndex, mNumberOfProcesses);
+      SplitPrimariesBetweenProcesses();
+      return true;
+    }
+    mProcessIds.push_back(pid);
+  }
+  return false;
+}
+//------------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------------
+// The first (n % N) processes get one primary more than the others
+void GateApplicationMgr::SplitPrimariesBetweenProcesses()
+{
+  auto share = [this](long int n) {
+    return n/mNumberOfProcesses + ((n % mNumberOfProcesses) > mProcessIndex ? 1 : 0);
+  };
+  if (mAnAmountOfPrimariesPerRunIsRequested)
+    mRequestedAmountOfPrimariesPerRun = share(mRequestedAmountOfPrimariesPerRun);
+  else if (mATotalAmountOfPrimariesIsRequested)
+    mRequestedAmountOfPrimaries = share(mRequestedAmountOfPrimaries);
+  for (auto & n : mNumberOfPrimariesPerRun) n = share(n);
+}
+//------------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------------
+// End of a forked process: leave the image accumulators for the parent and
+// exit without going back to the macro
+void GateApplicationMgr::StopProcess()
+{
+  GateImageWithStatistic::WriteAccumulatorsOfAllImages("gate_process_images.bin");
+  G4cout << std::flush;
+  std::cout << std::flush;
+  std::cerr << std::flush;
+  fflush(NULL);
+  _exit(EXIT_SUCCESS);
+}
+//------------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------------
+// Wait for the forked processes, then reduce their outputs in process order:
+// ROOT files are merged with TFileMerger, and the images with statistic are
+// summed and saved again (scaling and uncertainty are computed on the sums).
+// Other outputs are left in the process directories.
+void GateApplicationMgr::MergeProcesses()
+{
+  bool failed = false;
+  for (size_t p=0; p<mProcessIds.size(); p++) {
+    int status = 0;
+    waitpid(mProcessIds[p], &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      GateWarning("Process " << p << " (pid " << mProcessIds[p] << ") failed");
+      failed = true;
+    }
+  }
+  mProcessIds.clear();
+  if (failed) GateError("At least one process failed, outputs are not merged");
+
+  GateMessage("Acquisition", 0, "============= Merge of " << mNumberOfProcesses << " processes =============\n");
+
+#ifdef G4ANALYSIS_USE_ROOT
+  // ordered map: files are merged in a reproducible order
+  std::map<std::string, std::vector<std::string> > rootFiles;
+  for (G4int p=0; p<mNumberOfProcesses; p++) {
+    std::filesystem::path dir(GetProcessDirectory(p));
+    for (auto & entry : std::filesystem::recursive_directory_iterator(dir)) {
+      if (entry.is_regular_file() && entry.path().extension() == ".root")
+        rootFiles[std::filesystem::relative(entry.path(), dir).string()].push_back(entry.path().string());
+    }
+  }
+  for (auto & f : rootFiles) {
+    GateMessage("Acquisition", 1, "Merge " << f.second.size() << " files into " << f.first << Gateendl);
+    TFileMerger merger(kFALSE);
+    merger.OutputFile(f.first.c_str(), "RECREATE");
+    for (auto & input : f.second) merger.AddFile(input.c_str(), kFALSE);
+    if (!merger.Merge()) GateError("Cannot merge the files into '" << f.first << "'");
+  }
+#endif
+
+  for (G4int p=0; p<mNumberOfProcesses; p++)
+    GateImageWithStatistic::AddAccumulatorsOfAllImages(GetProcessDirectory(p)+"/gate_process_images.bin");
+  int nbImages = GateImageWithStatistic::SaveAllMergedImages();
+  GateMessage("Acquisition", 0, "Merged " << nbImages << " actor images. Other outputs are in the directories "
+              << GetProcessDirectory(0) << " to " << GetProcessDirectory(mNumberOfProcesses-1) << Gateendl);
+}
+//------------------------------------------------------------------------------------------
+
+
 //------------------------------------------------------------------------------------------
 void GateApplicationMgr::Describe()
 {
@@ -119,6 +119,12 @@ GateApplicationMgrMessenger::GateApplicationMgrMessenger()
   ReadNumberOfPrimariesInAFileCmd = new G4UIcmdWithAString("/gate/application/readNumberOfPrimariesInAFile", this);
   ReadNumberOfPrimariesInAFileCmd->SetGuidance("Read the number of primaries per run in a file.");
 
+  SetNumberOfProcessesCmd = new G4UIcmdWithAnInteger("/gate/application/setNumberOfProcesses", this);
+  SetNumberOfProcessesCmd->SetGuidance("Split the acquisition between N forked local processes and merge their outputs.");
+  SetNumberOfProcessesCmd->SetGuidance("Requires a number of primaries (setTotalNumberOfPrimaries or setNumberOfPrimariesPerRun).");
+  SetNumberOfProcessesCmd->SetParameterName("N",false);
+  SetNumberOfProcessesCmd->SetRange("N>=1");
+
 
   TimeStudyCmd = new G4UIcmdWithAString("/gate/application/enableTrackTimeStudy", this);
   TimeStudyCmd->SetGuidance("Activate the time measurement of tracks (Slow down the simulation).");
@@ -159,6 +165,7 @@ GateApplicationMgrMessenger::~GateApplicationMgrMessenger()
 
   //LSLS
   delete ReadNumberOfPrimariesInAFileCmd;
+  delete SetNumberOfProcessesCmd;
 
 }
 //-------------------------------------------------------------------------------------------------------------------
@@ -242,6 +249,9 @@ void GateApplicationMgrMessenger::SetNewValue(G4UIcommand* command, G4String new
   else if (command == ReadNumberOfPrimariesInAFileCmd) {
   appMgr->ReadNumberOfPrimariesInAFile(newValue);
   }
+  else if (command == SetNumberOfProcessesCmd) {
+    appMgr->SetNumberOfProcesses(SetNumberOfProcessesCmd->GetNewIntValue(newValue));
+  }
   else if (command == TimeStudyCmd) {
     appMgr->EnableTimeStudy(newValue);
   }
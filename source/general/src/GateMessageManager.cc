@@ -15,6 +15,9 @@ See LICENSE.md for further details
 //-----------------------------------------------------------
 
 #include "GateMessageManager.hh"
+#include <mutex>
+
+int GateMessageManager::mEffectiveLevel[GateMessageManager::MaxNumberOfMessageTypes];
 
 //-----------------------------------------------------------
 GateMessageManager::GateMessageManager()
@@ -171,6 +174,7 @@ void GateMessageManager::RegisterMessageType(std::string key,
   GetInstance()->mMessageHelp[key] = help;
   if (GetInstance()->mMaxMessageLength<key.length())
     GetInstance()->mMaxMessageLength = key.length();
+  GetInstance()->UpdateEffectiveLevels();
 }
 //-----------------------------------------------------------
 
@@ -198,19 +202,48 @@ void GateMessageManager::SetMessageLevel(std::string key,
 		<<key<<"> unregistered");
     }
   }
+  GetInstance()->UpdateEffectiveLevels();
 }
 //-----------------------------------------------------------
 
 //-----------------------------------------------------------
 int GateMessageManager::GetMessageLevel(std::string key)
 {
-  int l = GetInstance()->mAllLevel;
-  std::map<std::string,int>::iterator i =
-    GetInstance()->mMessageLevel.find(key);
-  if (i!=GetInstance()->mMessageLevel.end()) {
-    if ( (*i).second > l ) l = (*i).second;
+  return GetMessageLevel(GetMessageTypeHandle(key));
+}
+//-----------------------------------------------------------
+
+//-----------------------------------------------------------
+// Called once per macro call site (static handle), may be called from
+// several threads
+int GateMessageManager::GetMessageTypeHandle(const std::string & key)
+{
+  static std::mutex mutex;
+  GateMessageManager * m = GetInstance();
+  std::lock_guard<std::mutex> lock(mutex);
+  std::map<std::string,int>::iterator i = m->mMessageTypeHandle.find(key);
+  if (i!=m->mMessageTypeHandle.end()) return (*i).second;
+  int handle = m->mMessageTypeKey.size();
+  if (handle >= MaxNumberOfMessageTypes)
+    GateError("MessageManager : too many message types, cannot add <" << key << ">");
+  m->mMessageTypeHandle[key] = handle;
+  m->mMessageTypeKey.push_back(key);
+  m->UpdateEffectiveLevels();
+  return handle;
+}
+//-----------------------------------------------------------
+
+//-----------------------------------------------------------
+// Same rule as before the handles: the level of a type is the max of its
+// own level and of the "All" level, types not registered get the "All" level
+void GateMessageManager::UpdateEffectiveLevels()
+{
+  for (unsigned int h=0; h<mMessageTypeKey.size(); h++) {
+    int l = mAllLevel;
+    std::map<std::string,int>::iterator i = mMessageLevel.find(mMessageTypeKey[h]);
+    if (i!=mMessageLevel.end() && (*i).second > l) l = (*i).second;
+    mEffectiveLevel[h] = l;
   }
-  return l;
 }
 //-----------------------------------------------------------
 
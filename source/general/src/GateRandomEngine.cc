@@ -16,6 +16,7 @@
 #include <ctime>
 #include <cstdlib>
 #include <random>
+#include <functional>
 #include "GateMessageManager.hh"
 
 #ifdef G4ANALYSIS_USE_ROOT
@@ -173,3 +174,35 @@ void GateRandomEngine::Initialize() {
   // True initialization
   CLHEP::HepRandom::setTheEngine(theRandomEngine);
 }
+
+
+void GateRandomEngine::InitializeForProcess(G4int processIndex, G4int numberOfProcesses) {
+  // All forked processes start from the same engine state: each one draws the
+  // same list of seeds and keeps its own entry. The seeds stay below 900000000,
+  // which is the range of independent sequences of HepJamesRandom.
+  long seed = 0;
+  for (G4int i=0; i<numberOfProcesses; i++) {
+    long s = static_cast<long>(theRandomEngine->flat()*900000000.0);
+    if (i == processIndex) seed = s;
+  }
+  theRandomEngine->setSeed(seed, 0);
+
+  std::srand(static_cast<unsigned int>(*theRandomEngine));
+  srandom(static_cast<unsigned int>(*theRandomEngine));
+
+#ifdef G4ANALYSIS_USE_ROOT
+  gRandom->SetSeed(static_cast<unsigned int>(*theRandomEngine));
+#endif
+
+  CLHEP::HepRandom::setTheEngine(theRandomEngine);
+}
+
+
+CLHEP::HepRandomEngine* GateRandomEngine::CreateStreamEngine(const G4String& streamName) const {
+  // Adding or removing a stream does not change the seeds of the other streams
+  size_t key = std::hash<std::string>()(streamName);
+  key ^= std::hash<long>()(theRandomEngine->getSeed()) + 0x9e3779b9 + (key<<6) + (key>>2);
+  CLHEP::HepRandomEngine* engine = new CLHEP::HepJamesRandom();
+  engine->setSeed(static_cast<long>(key % 900000000), 0);
+  return engine;
+}
@@ -0,0 +1,51 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+
+#include "GateStringTable.hh"
+
+
+//-----------------------------------------------------------------------------------
+// Static pointer to the GateStringTable singleton
+GateStringTable* GateStringTable::pInstance = 0;
+//-----------------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------------
+GateStringTable* GateStringTable::GetInstance()
+{
+  if (!pInstance)
+    pInstance = new GateStringTable();
+  return pInstance;
+}
+//-----------------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------------
+// Handle 0: empty string
+GateStringTable::GateStringTable()
+{
+  m_strings.push_back(G4String());
+  m_handles[m_strings.back()] = 0;
+}
+//-----------------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------------
+G4int GateStringTable::GetHandle(const G4String& aString)
+{
+  std::unordered_map<std::string,G4int>::const_iterator iter = m_handles.find(aString);
+  if (iter != m_handles.end())
+    return iter->second;
+
+  G4int handle = m_strings.size();
+  m_strings.push_back(aString);
+  m_handles[aString] = handle;
+  return handle;
+}
+//-----------------------------------------------------------------------------------
@@ -50,6 +50,9 @@ class GateOutputVolumeID : public std::vector<G4int>
     //! Extract the topmost elements of the ID, down to the level 'depth'
     //! Returns an ID with (depth+1) elements
     GateOutputVolumeID Top(size_t depth) const;
+
+    //! Returns a hash of the elements, equal IDs have equal keys
+    size_t GetHashKey() const;
 };
 
 inline GateOutputVolumeID::GateOutputVolumeID(size_t itsSize)
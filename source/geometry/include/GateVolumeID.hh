@@ -129,6 +129,9 @@ class GateVolumeID : public std::vector<GateVolumeSelector>
     inline const GateVolumeSelector& GetSelector(size_t depth) const
       { return (*this)[depth]; }    
 
+    //! Returns a hash of the path (creators and copy numbers), equal volumeIDs have equal keys
+    size_t GetHashKey() const;
+
     //! Appends a new level at the end of the vector
     inline void InsertVolumeLevel(G4VPhysicalVolume* volume)
     { insert(begin(),GateVolumeSelector(volume)); }
@@ -0,0 +1,94 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+
+#ifndef GateVolumeIDTable_h
+#define GateVolumeIDTable_h 1
+
+#include "globals.hh"
+#include <deque>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+#include "GateVolumeID.hh"
+#include "GateOutputVolumeID.hh"
+
+class G4TouchableHistory;
+class G4VPhysicalVolume;
+
+/*! \class  GateVolumeIDTable
+    \brief  Stores each volumeID and output volumeID once, hits and digis only keep an integer handle
+
+    - The GateVolumeIDTable is a singleton. The number of distinct volumeIDs is bounded by
+      the number of sensitive volumes, so the table does not grow once all volumes have
+      been hit.
+
+    - A handle is found from a touchable without building a GateVolumeID: the path
+      (physical volume and copy number of each level) is hashed on the stack and compared
+      with the paths already seen. The GateVolumeID is only built for a new path.
+
+    - Handle 0 is the empty volumeID (resp. the default, invalid, output volumeID).
+      The references returned by GetVolumeID() and GetOutputVolumeID() stay valid for the
+      whole simulation.
+*/
+class GateVolumeIDTable
+{
+  public:
+    //! Returns the GateVolumeIDTable singleton (created on first call)
+    static GateVolumeIDTable* GetInstance();
+
+    ~GateVolumeIDTable() {}
+
+  private:
+    GateVolumeIDTable();   //!< Private constructor: this function should only be called from GetInstance()
+
+  public:
+    //! \name Volume IDs
+    //@{
+    //! Returns the handle of the volumeID of a touchable
+    G4int GetVolumeIDHandle(const G4TouchableHistory* touchable);
+    //! Returns the handle of a volumeID (stored if not yet known)
+    G4int GetVolumeIDHandle(const GateVolumeID& volumeID);
+    //! Returns the volumeID of a handle
+    inline const GateVolumeID& GetVolumeID(G4int handle) const
+      { return m_volumeIDs[handle]; }
+    //@}
+
+    //! \name Output volume IDs
+    //@{
+    //! Returns the handle of an output volumeID (stored if not yet known)
+    G4int GetOutputVolumeIDHandle(const GateOutputVolumeID& outputVolumeID);
+    //! Returns the output volumeID of a handle
+    inline const GateOutputVolumeID& GetOutputVolumeID(G4int handle) const
+      { return m_outputVolumeIDs[handle]; }
+    //@}
+
+    //! Number of volumeIDs stored (including the empty one)
+    inline size_t GetNumberOfVolumeIDs() const { return m_volumeIDs.size(); }
+
+  private:
+    typedef std::vector<std::pair<const G4VPhysicalVolume*,G4int> > TouchablePath;
+
+    //! Returns true if the path is the one of the touchable
+    static G4bool IsPathOf(const TouchablePath& path, const G4TouchableHistory* touchable);
+
+    // deques: the references to the IDs stay valid when the table grows
+    std::deque<GateVolumeID>       m_volumeIDs;
+    std::deque<GateOutputVolumeID> m_outputVolumeIDs;
+
+    //! Hash key -> handle (multimaps: different IDs may have the same key)
+    std::unordered_multimap<size_t,G4int> m_volumeIDIndex;
+    std::unordered_multimap<size_t,G4int> m_outputVolumeIDIndex;
+    std::unordered_multimap<size_t,std::pair<TouchablePath,G4int> > m_touchableIndex;
+
+    //! Static pointer to the GateVolumeIDTable singleton
+    static GateVolumeIDTable* pInstance;
+};
+
+#endif
@@ -10,6 +10,7 @@ See LICENSE.md for further details
 #include "GateOutputVolumeID.hh"
 
 #include <iomanip>
+#include <functional>
 
 
 
@@ -52,3 +53,15 @@ GateOutputVolumeID GateOutputVolumeID::Top(size_t maxDepth) const
   return topID;
 }
 
+
+
+
+// Returns a hash of the elements, equal IDs have equal keys
+size_t GateOutputVolumeID::GetHashKey() const
+{
+  size_t key = size();
+  for (const_iterator iter=begin(); iter!=end(); ++iter)
+    key ^= std::hash<G4int>()(*iter) + 0x9e3779b9 + (key<<6) + (key>>2);
+  return key;
+}
+
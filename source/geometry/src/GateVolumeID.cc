@@ -9,6 +9,8 @@ See LICENSE.md for further details
 
 #include "GateVolumeID.hh"
 
+#include <functional>
+
 #include "G4UnitsTable.hh"
 #include "G4TouchableHistory.hh"
 
@@ -109,6 +111,20 @@ GateVolumeID::GateVolumeID(G4int *daughterID, size_t arraySize)
 
 
 
+//-----------------------------------------------------------------------------------
+// Combines the creator and copy number of each level, as compared by operator==
+size_t GateVolumeID::GetHashKey() const
+{
+  size_t key = size();
+  for (const_iterator iter=begin(); iter!=end(); ++iter) {
+    key ^= std::hash<const void*>()(iter->GetCreator()) + 0x9e3779b9 + (key<<6) + (key>>2);
+    key ^= std::hash<G4int>()(iter->GetCopyNo()) + 0x9e3779b9 + (key<<6) + (key>>2);
+  }
+  return key;
+}
+//-----------------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------------
 G4int GateVolumeID::GetCreatorDepth (G4String name) const                
 {     
@@ -0,0 +1,124 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+
+#include "GateVolumeIDTable.hh"
+
+#include <functional>
+
+#include "G4TouchableHistory.hh"
+#include "G4VPhysicalVolume.hh"
+
+
+//-----------------------------------------------------------------------------------
+// Static pointer to the GateVolumeIDTable singleton
+GateVolumeIDTable* GateVolumeIDTable::pInstance = 0;
+//-----------------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------------
+GateVolumeIDTable* GateVolumeIDTable::GetInstance()
+{
+  if (!pInstance)
+    pInstance = new GateVolumeIDTable();
+  return pInstance;
+}
+//-----------------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------------
+// Handle 0: empty volumeID and default output volumeID
+GateVolumeIDTable::GateVolumeIDTable()
+{
+  m_volumeIDs.push_back(GateVolumeID());
+  m_volumeIDIndex.insert(std::make_pair(m_volumeIDs.back().GetHashKey(), 0));
+  m_outputVolumeIDs.push_back(GateOutputVolumeID());
+  m_outputVolumeIDIndex.insert(std::make_pair(m_outputVolumeIDs.back().GetHashKey(), 0));
+}
+//-----------------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------------
+// The path of a touchable is made of the physical volume and copy number of each level,
+// from the bottom volume up to (excluding) the world, as read by GateVolumeID(touchable)
+G4int GateVolumeIDTable::GetVolumeIDHandle(const G4TouchableHistory* touchable)
+{
+  if ( (!touchable) || (!touchable->GetVolume()) )
+    return 0;
+
+  const G4int depth = touchable->GetHistoryDepth();
+  size_t key = depth;
+  for (G4int i=0; i<depth; ++i) {
+    const G4VPhysicalVolume* volume = touchable->GetVolume(i);
+    key ^= std::hash<const void*>()(volume) + 0x9e3779b9 + (key<<6) + (key>>2);
+    key ^= std::hash<G4int>()(volume->GetCopyNo()) + 0x9e3779b9 + (key<<6) + (key>>2);
+  }
+
+  auto range = m_touchableIndex.equal_range(key);
+  for (auto iter=range.first; iter!=range.second; ++iter)
+    if (IsPathOf(iter->second.first, touchable))
+      return iter->second.second;
+
+  // New path: build its volumeID (the same volumeID may already be known from another path)
+  TouchablePath path(depth);
+  for (G4int i=0; i<depth; ++i)
+    path[i] = std::make_pair(touchable->GetVolume(i), touchable->GetVolume(i)->GetCopyNo());
+  G4int handle = GetVolumeIDHandle(GateVolumeID(touchable));
+  m_touchableIndex.insert(std::make_pair(key, std::make_pair(path, handle)));
+  return handle;
+}
+//-----------------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------------
+G4bool GateVolumeIDTable::IsPathOf(const TouchablePath& path, const G4TouchableHistory* touchable)
+{
+  if ((G4int)path.size() != touchable->GetHistoryDepth())
+    return false;
+  for (size_t i=0; i<path.size(); ++i) {
+    const G4VPhysicalVolume* volume = touchable->GetVolume(i);
+    if ( (path[i].first != volume) || (path[i].second != volume->GetCopyNo()) )
+      return false;
+  }
+  return true;
+}
+//-----------------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------------
+G4int GateVolumeIDTable::GetVolumeIDHandle(const GateVolumeID& volumeID)
+{
+  const size_t key = volumeID.GetHashKey();
+  auto range = m_volumeIDIndex.equal_range(key);
+  for (auto iter=range.first; iter!=range.second; ++iter)
+    if (m_volumeIDs[iter->second] == volumeID)
+      return iter->second;
+
+  G4int handle = m_volumeIDs.size();
+  m_volumeIDs.push_back(volumeID);
+  m_volumeIDIndex.insert(std::make_pair(key, handle));
+  return handle;
+}
+//-----------------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------------
+G4int GateVolumeIDTable::GetOutputVolumeIDHandle(const GateOutputVolumeID& outputVolumeID)
+{
+  const size_t key = outputVolumeID.GetHashKey();
+  auto range = m_outputVolumeIDIndex.equal_range(key);
+  for (auto iter=range.first; iter!=range.second; ++iter)
+    if (m_outputVolumeIDs[iter->second] == outputVolumeID)
+      return iter->second;
+
+  G4int handle = m_outputVolumeIDs.size();
+  m_outputVolumeIDs.push_back(outputVolumeID);
+  m_outputVolumeIDIndex.insert(std::make_pair(key, handle));
+  return handle;
+}
+//-----------------------------------------------------------------------------------
@@ -22,6 +22,9 @@ public:
 
   GateRTPhantom * CheckGeometryAttached( G4String aname);
 
+  //! True if at least one phantom is enabled (its activities change with time)
+  G4bool HasEnabledPhantoms();
+
 
   //! Used to create and access the OutputMgr
   static GateRTPhantomMgr* GetInstance() {
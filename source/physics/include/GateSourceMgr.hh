@@ -20,6 +20,7 @@
 #include "GateSourcePencilBeam.hh"
 #include "GateSourceTPSPencilBeam.hh"
 #include "GateSourceFastY90.hh"
+#include "GateAliasTable.hh"
 
 class GateSourceMgrMessenger;
 
@@ -40,6 +41,12 @@ class GateSourceMgrMessenger;
  * For each event, it decides which source is to be used and it asks to this source
  * to generate the primary vertices.
  *
+ * When all sources have a constant activity during the Run, the next decay time of
+ * each source is kept in a min-heap: only the source of the previous event proposes
+ * a new time, so choosing a source costs O(log N) instead of N calls to GetNextTime.
+ * In the total-amount-of-primaries mode, the source is drawn from an alias table
+ * of the intensities.
+ *
  * GateSourceMgr is a singleton.
  * @author G.Santin
  *
@@ -130,6 +137,13 @@ protected:
   GateSourceMgr();
   G4int CheckSourceName( G4String sourceName );
 
+  /** Returns true if the activity of all sources is constant from the current time,
+   * i.e. if their decay intervals are exponential with a fixed rate.
+   */
+  G4bool CanUseNextTimeQueue();
+  /** Samples the next decay time of all sources (first event of a Run) */
+  void InitNextTimeQueue();
+
   static GateSourceMgr*     mInstance;
   GateVSourceVector         mSources;
   GateVSource*              m_previousSource;
@@ -161,6 +175,12 @@ protected:
 
   std::vector<int>          mSourceID;
 
+  GateAliasTable            mIntensityTable;      // source index drawn with a probability proportional to its intensity
+  std::vector<std::pair<G4double,G4int> > mNextTimeQueue;  // min-heap of (absolute next decay time, source index)
+  G4int                     mNextTimeQueueSource; // source taken from the queue for the previous event, -1 if none
+  G4bool                    mNextTimeQueueNeedsInit;
+  G4bool                    mUseNextTimeQueue;
+
   /* PY Descourt 08/09/2008 */
   G4int m_currentSourceID; // for detector mode
   GateVSource* m_fictiveSource; // idem
@@ -34,6 +34,7 @@
 #include "G4ParticleMomentum.hh"
 #include <iomanip>
 #include <vector>
+#include <unordered_map>
 
 #include "GateVSource.hh"
 #include "GateSourcePhaseSpaceMessenger.hh"
@@ -89,6 +90,10 @@ public:
 
     void InitializeTransformation();
 
+    void InitializeRunTransformation();
+
+    G4ParticleDefinition *GetParticleDefinitionOfROOTEntry();
+
     G4ThreeVector SetReferencePosition(G4ThreeVector coordLocal);
 
     G4ThreeVector SetReferenceMomentum(G4ThreeVector coordLocal);
@@ -236,6 +241,18 @@ protected:
     std::vector<const G4RotationMatrix *> mListOfRotation;
     std::vector<G4ThreeVector> mListOfTranslation;
 
+    // Transformations composed once per run (see InitializeRunTransformation)
+    G4RotationMatrix mReferenceRotation;
+    G4ThreeVector mReferenceTranslation;
+    bool mIsAttachedToVolume;
+    G4RotationMatrix mAttachedVolumeRotation;
+    G4ThreeVector mAttachedVolumeTranslation;
+
+    // Particle definitions already found, by PDG code, and for the last particle name
+    std::unordered_map<G4int, G4ParticleDefinition *> mParticleDefinitionOfPDGCode;
+    std::string mLastParticleName;
+    G4ParticleDefinition *pLastParticleNameDefinition;
+
     bool mUseRegularSymmetry;
     bool mUseRandomSymmetry;
     double mAngle;
@@ -94,6 +94,14 @@ public:
 
 protected:
 
+  //Beam model parameters of one energy of the plan
+  struct SpotConfiguration {
+    double energy, sigmaEnergy; // source energy and energy spread (MeV)
+    double sigmaX, sigmaY, sigmaTheta, sigmaPhi;
+    double ellipseXThetaArea, ellipseYPhiArea;
+  };
+
+  void BuildSpotConfigurations();
   void ConfigurePencilBeam();
   GateSourceTPSPencilBeamMessenger * pMessenger;
 
@@ -149,6 +157,8 @@ protected:
   std::vector<double> mSpotWeight; // (proportional to) the expected number (for each bin in a multinomial distribution)
   std::vector<int> mNbIonsToGenerate; // the actual number (for each bin in a multinomial distribution)
   std::vector<G4ThreeVector> mSpotPosition, mSpotRotation;
+  std::vector<SpotConfiguration> mSpotConfigurations; // one per energy of the plan
+  std::vector<int> mSpotConfigurationIndex; // configuration of each spot
 };
 //------------------------------------------------------------------------------------------------------
 // vim: ai sw=2 ts=2 et
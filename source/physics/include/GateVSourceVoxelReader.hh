@@ -14,6 +14,7 @@
 #include <map>
 #include "globals.hh"
 #include "G4ThreeVector.hh"
+#include "GateAliasTable.hh"
 
 class GateVSource;
 class GateVSourceVoxelTranslator;
@@ -87,10 +88,9 @@ protected:
   G4String                       m_name;
   G4String                       m_fileName;
   GateVSource*                   m_source;
-  typedef std::map<G4double,G4int >  GateSourceIntegratedActivityMap;
   GateSourceActivityMap           m_sourceVoxelActivities;
-  GateSourceIntegratedActivityMap m_sourceVoxelIntegratedActivities;
-  void PrepareIntegratedActivityMap();
+  GateAliasTable                  m_sourceVoxelAliasTable;  //!< Draws the emitting voxel from m_sourceVoxelActivities
+  void PrepareActivityAliasTable();
   G4ThreeVector                  m_voxelSize;
   G4int							 m_voxelNx;
   G4int							 m_voxelNy;
@@ -12,6 +12,7 @@
 
 #include "globals.hh"
 #include "GateSPSPosDistribution.hh"
+#include "GateAliasTable.hh"
 
 
 class GateVoxelizedPosDistribution : public GateSPSPosDistribution
@@ -28,9 +29,7 @@ private:
   G4ThreeVector mResolution;     // resolution of data
 
   G4int m_nx, m_ny, m_nz;     // size of voxelized distribution
-  G4double *mPosDistZCDF;   // Cumulative distribution function in Z
-  G4double **mPosDistYCDF;  // CDF in Y
-  G4double ***mPosDistXCDF;
+  GateAliasTable mVoxelTable; // draws the voxel (x fastest), empty voxels have no bin
 
 };
 
@@ -60,6 +60,13 @@ for (std::vector<GateRTPhantom*>::iterator itr = m_RTPhantom.begin(); itr != m_R
 return Ph;      
 }
 
+G4bool GateRTPhantomMgr::HasEnabledPhantoms()
+{
+for (std::vector<GateRTPhantom*>::iterator itr = m_RTPhantom.begin(); itr != m_RTPhantom.end(); itr++)
+  if ( (*itr)->GetEnabled() ) return true;
+return false;
+}
+
 GateRTPhantomMgr::GateRTPhantomMgr(const G4String name)
   : m_verboseLevel(2),
     m_messenger(0),
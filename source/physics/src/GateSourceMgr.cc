@@ -25,6 +25,8 @@
 #include "GateRTPhantomMgr.hh"
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <functional>
 #include "GateActions.hh"
 #include "G4RunManager.hh"
 #include "GateSourceOfPromptGamma.hh"
@@ -52,6 +54,9 @@ GateSourceMgr::GateSourceMgr()
   m_currentSourceID = -1;
   mTotalIntensity=0.;
   m_launchLastBuffer = false;
+  mNextTimeQueueSource = -1;
+  mNextTimeQueueNeedsInit = true;
+  mUseNextTimeQueue = false;
 }
 //----------------------------------------------------------------------------------------
 
@@ -315,37 +320,59 @@ GateVSource* GateSourceMgr::GetNextSource()
   G4double aTime;
 
   if (IsTotalAmountOfPrimariesModeEnabled()) {
-    G4double randNumber = G4UniformRand()*mTotalIntensity;
-    G4double sumIntensity=0.;
-    G4int currentSourceNumber = 0;
-    while ( (currentSourceNumber<(int)mSources.size()) && (sumIntensity<=randNumber)){
-      pFirstSource = mSources[ currentSourceNumber ];
-      sumIntensity += pFirstSource->GetIntensity();
-      currentSourceNumber++;
-    }
+    // same probabilities as the cumulative intensity scan, with one random number
+    if( mIntensityTable.IsEmpty() )
+      GateError( "GateSourceMgr::GetNextSource : ERROR : the sources have no positive intensity" );
+    pFirstSource = mSources[ mIntensityTable.Sample() ];
 
     m_firstTime = GateApplicationMgr::GetInstance()->GetTimeStepInTotalAmountOfPrimariesMode();
   }
   else {
-    // if there is at least one source
-    // make a competition among all the available sources
-    // the source that proposes the shortest interval for the next event wins
-    GateVSourceVector::iterator itr;
-    for( itr = mSources.begin(); itr != mSources.end(); ++itr )
-      {
-        aTime = (*itr)->GetNextTime( m_time ); // compute random time for this source
-        if( mVerboseLevel > 1 )
-          G4cout << "GateSourceMgr::GetNextSource : source "
-                 << (*itr)->GetName()
-                 << "    Next time (s) : " << aTime/s
-                 << "   m_firstTime (s) : " << m_firstTime/s << Gateendl;
-
-        if( m_firstTime < 0. || ( aTime < m_firstTime ) )
-          {
-            m_firstTime = aTime;
-            pFirstSource = *itr;
-          }
+    if( mNextTimeQueueNeedsInit ) InitNextTimeQueue();
+
+    if( mUseNextTimeQueue ) {
+      // The source of the previous event proposes its next time, the other sources keep
+      // theirs: with constant activities the intervals are exponential (memoryless), so
+      // this is the same competition as if all sources proposed a new time.
+      // The new time is sampled now rather than at the previous event, so that a change
+      // of activity during that event (e.g. wash-out actor) is taken into account.
+      if( mNextTimeQueueSource >= 0 ) {
+        aTime = mSources[ mNextTimeQueueSource ]->GetNextTime( m_time );
+        mNextTimeQueue.push_back( std::make_pair( m_time + aTime, mNextTimeQueueSource ) );
+        std::push_heap( mNextTimeQueue.begin(), mNextTimeQueue.end(), std::greater<std::pair<G4double,G4int> >() );
       }
+      std::pop_heap( mNextTimeQueue.begin(), mNextTimeQueue.end(), std::greater<std::pair<G4double,G4int> >() );
+      mNextTimeQueueSource = mNextTimeQueue.back().second;
+      m_firstTime = mNextTimeQueue.back().first - m_time;
+      mNextTimeQueue.pop_back();
+      pFirstSource = mSources[ mNextTimeQueueSource ];
+
+      if( mVerboseLevel > 1 )
+        G4cout << "GateSourceMgr::GetNextSource : source "
+               << pFirstSource->GetName()
+               << "   m_firstTime (s) : " << m_firstTime/s << Gateendl;
+    }
+    else {
+      // if there is at least one source
+      // make a competition among all the available sources
+      // the source that proposes the shortest interval for the next event wins
+      GateVSourceVector::iterator itr;
+      for( itr = mSources.begin(); itr != mSources.end(); ++itr )
+        {
+          aTime = (*itr)->GetNextTime( m_time ); // compute random time for this source
+          if( mVerboseLevel > 1 )
+            G4cout << "GateSourceMgr::GetNextSource : source "
+                   << (*itr)->GetName()
+                   << "    Next time (s) : " << aTime/s
+                   << "   m_firstTime (s) : " << m_firstTime/s << Gateendl;
+
+          if( m_firstTime < 0. || ( aTime < m_firstTime ) )
+            {
+              m_firstTime = aTime;
+              pFirstSource = *itr;
+            }
+        }
+    }
   }
 
   m_currentSourceID = pFirstSource->GetSourceID(); /* PY Descourt 08/09/2009 */
@@ -355,6 +382,50 @@ GateVSource* GateSourceMgr::GetNextSource()
 //----------------------------------------------------------------------------------------
 
 
+//----------------------------------------------------------------------------------------
+G4bool GateSourceMgr::CanUseNextTimeQueue()
+{
+  // RT phantoms update the activities of their voxelized sources at each event
+  if( GateRTPhantomMgr::GetInstance()->HasEnabledPhantoms() )
+    return false;
+
+  // Sources with a forced lifetime decay during the Run, and sources that have not
+  // started yet have a null activity until their start time: they must propose a new
+  // time at each event
+  for( size_t i = 0; i != mSources.size(); ++i ) {
+    GateVSource* source = mSources[ i ];
+    if( source->GetForcedUnstableFlag() && source->GetForcedHalfLife() > 0. )
+      return false;
+    if( m_time < source->GetStartTime() )
+      return false;
+  }
+  return true;
+}
+//----------------------------------------------------------------------------------------
+
+
+//----------------------------------------------------------------------------------------
+void GateSourceMgr::InitNextTimeQueue()
+{
+  mNextTimeQueueNeedsInit = false;
+  mNextTimeQueueSource = -1;
+  mNextTimeQueue.clear();
+  mUseNextTimeQueue = CanUseNextTimeQueue();
+  if( !mUseNextTimeQueue ) {
+    if( mVerboseLevel > 0 )
+      G4cout << "GateSourceMgr::InitNextTimeQueue : time-dependent activity, "
+             << "all sources propose a new time at each event\n";
+    return;
+  }
+
+  mNextTimeQueue.reserve( mSources.size() );
+  for( size_t i = 0; i != mSources.size(); ++i )
+    mNextTimeQueue.push_back( std::make_pair( m_time + mSources[ i ]->GetNextTime( m_time ), (G4int)i ) );
+  std::make_heap( mNextTimeQueue.begin(), mNextTimeQueue.end(), std::greater<std::pair<G4double,G4int> >() );
+}
+//----------------------------------------------------------------------------------------
+
+
 //----------------------------------------------------------------------------------------
 void GateSourceMgr::ListSources()
 {
@@ -436,6 +507,10 @@ void GateSourceMgr::Initialization()//std::vector<G4double> * time, std::vector<
       mTotalIntensity += (*itr)->GetIntensity();// intensity;
     }
 
+  std::vector<G4double> intensities( mSources.size() );
+  for( size_t i = 0; i != mSources.size(); ++i )
+    intensities[ i ] = mSources[ i ]->GetIntensity();
+  mIntensityTable.Build( intensities );
 }
 //----------------------------------------------------------------------------------------
 
@@ -487,6 +562,9 @@ G4int GateSourceMgr::PrepareNextRun( const G4Run* r)
   // flag for the initialization of the sources
   m_needSourceInit = true;
 
+  // the next decay times are sampled again at the first event of the Run
+  mNextTimeQueueNeedsInit = true;
+
   // Update the sources (for example for new positioning according to the geometry movements)
   for(GateVSourceVector::iterator itr = mSources.begin(); itr != mSources.end(); ++itr )
     (*itr)->Update(m_time);
@@ -95,6 +95,8 @@ GateSourcePhaseSpace::GateSourcePhaseSpace(G4String name) : GateVSource(name)
     mTimeIsUsed = true;
     mPDGCode = 0; // 0 is generic ion
     mPDGCodeGivenByUser = 0;
+    mIsAttachedToVolume = false;
+    pLastParticleNameDefinition = nullptr;
 }
 // ----------------------------------------------------------------------------------
 
@@ -459,6 +461,41 @@ void GateSourcePhaseSpace::GenerateROOTVertex(G4Event * /*aEvent*/)
     else
         mChain.read_entrie(mCurrentParticleNumberInFile);
 
+    // The particle definition is only searched in the particle tables for a new PDG code or name
+    if (mPDGCode != 0)
+    {
+        auto it = mParticleDefinitionOfPDGCode.find(mPDGCode);
+        if (it != mParticleDefinitionOfPDGCode.end())
+            pParticleDefinition = it->second;
+        else
+        {
+            pParticleDefinition = GetParticleDefinitionOfROOTEntry();
+            mParticleDefinitionOfPDGCode[mPDGCode] = pParticleDefinition;
+        }
+    }
+    else
+    {
+        if (pLastParticleNameDefinition == nullptr || mLastParticleName != particleName)
+        {
+            pLastParticleNameDefinition = GetParticleDefinitionOfROOTEntry();
+            mLastParticleName = particleName;
+        }
+        pParticleDefinition = pLastParticleNameDefinition;
+    }
+
+    // std::cout << "pParticleDefinition: " << pParticleDefinition << "\n";
+
+    if (mIsPair)
+        GenerateROOTVertexPairs();
+    else
+        GenerateROOTVertexSingle();
+}
+// ----------------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------------
+G4ParticleDefinition *GateSourcePhaseSpace::GetParticleDefinitionOfROOTEntry()
+{
+    G4ParticleDefinition *definition = nullptr;
     G4ParticleTable *particleTable = G4ParticleTable::GetParticleTable();
     G4IonTable *ionTable = G4IonTable::GetIonTable();
 
@@ -469,40 +506,35 @@ void GateSourcePhaseSpace::GenerateROOTVertex(G4Event * /*aEvent*/)
     // if PDGCode exists, use this one before particleName
     if (mPDGCode != 0)
     {
-        pParticleDefinition = particleTable->FindParticle((G4int)mPDGCode);
-        if (pParticleDefinition == 0)
+        definition = particleTable->FindParticle((G4int)mPDGCode);
+        if (definition == 0)
         {
-            pParticleDefinition = ionTable->GetIon((G4int)mPDGCode);
+            definition = ionTable->GetIon((G4int)mPDGCode);
         }
         // std::cout << "in here \n";
         // std::cout << "pParticleDefinition: " << pParticleDefinition << "\n";
     }
     else
-        pParticleDefinition = particleTable->FindParticle(particleName);
+        definition = particleTable->FindParticle(particleName);
     // if no valid PDGCode or particleName was found, use the user defined ones
     // first PDGCode is checked, if not found or valid, particleName is used
-    if (pParticleDefinition == 0)
+    if (definition == 0)
     {
         if (mPDGCodeGivenByUser != 0)
         {
-            pParticleDefinition = particleTable->FindParticle(mPDGCodeGivenByUser);
+            definition = particleTable->FindParticle(mPDGCodeGivenByUser);
         }
-        if (pParticleDefinition == 0)
+        if (definition == 0)
         {
             if (mParticleTypeNameGivenByUser != "none")
             {
-                pParticleDefinition = particleTable->FindParticle(mParticleTypeNameGivenByUser);
+                definition = particleTable->FindParticle(mParticleTypeNameGivenByUser);
             }
         }
-        if (pParticleDefinition == 0)
+        if (definition == 0)
             GateError("No particle type or PDGCode defined in phase space file or by user.");
     }
-    // std::cout << "pParticleDefinition: " << pParticleDefinition << "\n";
-
-    if (mIsPair)
-        GenerateROOTVertexPairs();
-    else
-        GenerateROOTVertexSingle();
+    return definition;
 }
 // ----------------------------------------------------------------------------------
 
@@ -748,6 +780,7 @@ G4int GateSourcePhaseSpace::GeneratePrimaries(G4Event *event)
         mCurrentParticleNumberInFile = mStartingParticleId;
         mRequestedNumberOfParticlesPerRun = 0.;
         mLastPartIndex = mCurrentParticleNumber;
+        InitializeRunTransformation();
 
         if (GateApplicationMgr::GetInstance()->GetNumberOfPrimariesPerRun())
             mRequestedNumberOfParticlesPerRun = GateApplicationMgr::GetInstance()->GetNumberOfPrimariesPerRun();
@@ -925,45 +958,40 @@ void GateSourcePhaseSpace::GenerateVertex(G4Event *event, G4ThreeVector &positio
 // ----------------------------------------------------------------------------------
 void GateSourcePhaseSpace::UpdatePositionAndMomentum(G4ThreeVector &position, G4ThreeVector &momentum)
 {
-    G4RotationMatrix rotation;
-
-    // Momentum
-    if (GetPositionInWorldFrame())
-        momentum = SetReferenceMomentum(momentum);
-    // momentum: convert world frame coordinate to local volume coordinate
-
-    if (GetUseRegularSymmetry() && mCurrentUse != 0)
+    // The volume transformations are composed once per run, only the symmetry rotation
+    // (around Z) changes from one particle to the other
+    bool useSymmetry = (GetUseRegularSymmetry() || GetUseRandomSymmetry()) && mCurrentUse != 0;
+    double cosAngle = 1.;
+    double sinAngle = 0.;
+    if (useSymmetry)
     {
-        rotation.rotateZ(mAngle * mCurrentUse);
-        momentum = rotation * momentum;
-    }
-    if (GetUseRandomSymmetry() && mCurrentUse != 0)
-    {
-        G4double randAngle = G4RandFlat::shoot(twopi);
-        rotation.rotateZ(randAngle);
-        momentum = rotation * momentum;
+        G4double angle = GetUseRegularSymmetry() ? mAngle * mCurrentUse : G4RandFlat::shoot(twopi);
+        cosAngle = std::cos(angle);
+        sinAngle = std::sin(angle);
     }
 
-    ChangeParticleMomentumRelativeToAttachedVolume(momentum);
+    // Momentum
+    // momentum: convert world frame coordinate to local volume coordinate
+    if (GetPositionInWorldFrame())
+        momentum = mReferenceRotation * momentum;
+    if (useSymmetry)
+        momentum.set(cosAngle * momentum.x() - sinAngle * momentum.y(),
+                     sinAngle * momentum.x() + cosAngle * momentum.y(),
+                     momentum.z());
+    if (mIsAttachedToVolume)
+        momentum = mAttachedVolumeRotation * momentum;
 
     // Position
     // convert world frame coordinate to local volume coordinate
     if (GetPositionInWorldFrame())
-        position = SetReferencePosition(position);
-
-    if (GetUseRegularSymmetry() && mCurrentUse != 0)
-    {
-        position = rotation * position;
-    }
-    if (GetUseRandomSymmetry() && mCurrentUse != 0)
-    {
-        position = rotation * position;
-    }
-
-    ChangeParticlePositionRelativeToAttachedVolume(position);
+        position = mReferenceRotation * position + mReferenceTranslation;
+    if (useSymmetry)
+        position.set(cosAngle * position.x() - sinAngle * position.y(),
+                     sinAngle * position.x() + cosAngle * position.y(),
+                     position.z());
+    if (mIsAttachedToVolume)
+        position = mAttachedVolumeRotation * position + mAttachedVolumeTranslation;
 }
-// ----------------------------------------------------------------------------------
-
 // ----------------------------------------------------------------------------------
 void GateSourcePhaseSpace::AddFile(G4String file)
 {
@@ -1065,6 +1093,42 @@ void GateSourcePhaseSpace::InitializeTransformation()
 }
 // ----------------------------------------------------------------------------------
 
+// ----------------------------------------------------------------------------------
+void GateSourcePhaseSpace::InitializeRunTransformation()
+{
+    // Same transformations as SetReferencePosition/SetReferenceMomentum and
+    // ChangeParticlePosition/MomentumRelativeToAttachedVolume, composed in one
+    // rotation and one translation (volumes may move between runs)
+    mReferenceRotation = G4RotationMatrix();
+    mReferenceTranslation = G4ThreeVector();
+    for (int j = mListOfRotation.size() - 1; j >= 0; j--)
+    {
+        const G4RotationMatrix *r = mListOfRotation[j];
+        mReferenceTranslation += mListOfTranslation[j];
+        if (r)
+        {
+            mReferenceTranslation = (*r) * mReferenceTranslation;
+            mReferenceRotation = (*r) * mReferenceRotation;
+        }
+    }
+
+    mAttachedVolumeRotation = G4RotationMatrix();
+    mAttachedVolumeTranslation = G4ThreeVector();
+    mIsAttachedToVolume = (mRelativePlacementVolumeName != "world");
+    if (!mIsAttachedToVolume)
+        return;
+    GateVVolume *v = mVolume;
+    while (v->GetObjectName() != "world")
+    {
+        G4RotationMatrix r = v->GetPhysicalVolume(0)->GetObjectRotationValue();
+        mAttachedVolumeRotation = r * mAttachedVolumeRotation;
+        mAttachedVolumeTranslation = r * mAttachedVolumeTranslation + v->GetPhysicalVolume(0)->GetObjectTranslation();
+        // next volume
+        v = v->GetParentVolume();
+    }
+}
+// ----------------------------------------------------------------------------------
+
 // ----------------------------------------------------------------------------------
 G4int GateSourcePhaseSpace::OpenIAEAFile(G4String file)
 {
@@ -21,11 +21,15 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <map>
 
 // geant4
 #include "globals.hh"
 #include "G4Event.hh"
 
+// CLHEP
+#include "CLHEP/Random/RandBinomial.h"
+
 // GATE
 #include "GateConfiguration.h"
 #include "GateRandomEngine.hh"
@@ -269,11 +273,22 @@ void GateSourceTPSPencilBeam::GenerateVertex( G4Event *aEvent ) {
     }
     mDistriGeneral = new RandGeneral(engine, mPDF, mTotalNumberOfSpots, 0);
     if (mSortedSpotGenerationFlag){
+      // Multinomial allocation of the primaries to the spots, one conditional binomial per spot:
+      // the number of ions of spot i is drawn among the ions left, with the probability of spot i
+      // among the spots left (same distribution as one draw per primary, in O(number of spots))
       mNbIonsToGenerate.resize(mTotalNumberOfSpots,0);
-      long int ntotal = GateApplicationMgr::GetInstance()->GetTotalNumberOfPrimaries();
-      for (long int i = 0; i<ntotal; i++){
-        int bin = mTotalNumberOfSpots * mDistriGeneral->fire();
-        ++mNbIonsToGenerate[bin];
+      long int nleft = GateApplicationMgr::GetInstance()->GetTotalNumberOfPrimaries();
+      std::vector<double> weightLeft(mTotalNumberOfSpots+1, 0.);
+      for (int i = mTotalNumberOfSpots-1; i >= 0; i--) {
+        weightLeft[i] = weightLeft[i+1] + mPDF[i];
+      }
+      for (int i = 0; i < mTotalNumberOfSpots && nleft > 0; i++) {
+        if (mPDF[i] <= 0) continue;
+        // p is exactly 1 for the last spot with a positive weight
+        double p = std::min(1., mPDF[i] / weightLeft[i]);
+        long int n = (p >= 1.) ? nleft : static_cast<long int>(CLHEP::RandBinomial::shoot(engine, nleft, p));
+        mNbIonsToGenerate[i] = n;
+        nleft -= n;
       }
       for (int i = 0; i < mTotalNumberOfSpots; i++) {
         GateMessage("Beam", 3, "[TPSPencilBeam] bin " << std::setw(5) << i << ": spotweight=" << std::setw(8) << mPDF[i] << ", Ngen=" << mNbIonsToGenerate[i] << Gateendl );
@@ -281,6 +296,16 @@ void GateSourceTPSPencilBeam::GenerateVertex( G4Event *aEvent ) {
       mCurrentSpot = 0;
     }
 
+    BuildSpotConfigurations();
+
+    //Particle Type
+    mPencilBeam->SetParticleType(mParticleType);
+    if (mIsGenericIon==true){
+      //Particle Properties If GenericIon
+      GateMessage("Beam", 5, "[TPSPencilBeam] configuring pencil beam with generic ion with parameters \"" << mParticleParameters << "\"" << Gateendl );
+      mPencilBeam->SetIonParameter(mParticleParameters);
+    }
+
   //Correlation Position/Direction
   //this parameter is not spot or energy dependent and is therefore once for all at the end of the initialization phase.
       if (mConvergentSourceXTheta) {
@@ -305,12 +330,12 @@ void GateSourceTPSPencilBeam::GenerateVertex( G4Event *aEvent ) {
     while ( (mCurrentSpot<mTotalNumberOfSpots) && (mNbIonsToGenerate[mCurrentSpot] <= 0) ){
       GateMessage("Beam", 4, "[TPSPencilBeam] spot " << mCurrentSpot << " has no ions left to generate." << Gateendl );
       mCurrentSpot++;
-      mCurrentLayer = mSpotLayer[mCurrentSpot];
       need_pencilbeam_config = true;
     }
     if ( mCurrentSpot>=mTotalNumberOfSpots ){
       GateError("Too many primary vertex requests!");
     }
+    mCurrentLayer = mSpotLayer[mCurrentSpot];
   } else {
     int nextspot = mTotalNumberOfSpots * mDistriGeneral->fire();
     need_pencilbeam_config = (nextspot!=mCurrentSpot);
@@ -330,38 +355,51 @@ void GateSourceTPSPencilBeam::GenerateVertex( G4Event *aEvent ) {
 //---------GENERATION - END-----------------------
 
 //------------------------------------------------------------------------------------------------------
-void GateSourceTPSPencilBeam::ConfigurePencilBeam() {
-  double energy = mSpotEnergy[mCurrentSpot];
-  GateMessage("Beam", 5, "[TPSPencilBeam] configuring pencil beam with E= " << energy << Gateendl );
-    //Particle Type
-    mPencilBeam->SetParticleType(mParticleType);
-  if (mIsGenericIon==true){
-    //Particle Properties If GenericIon
-    GateMessage("Beam", 5, "[TPSPencilBeam] configuring pencil beam with generic ion with parameters \"" << mParticleParameters << "\"" << Gateendl );
-    mPencilBeam->SetIonParameter(mParticleParameters);
+void GateSourceTPSPencilBeam::BuildSpotConfigurations() {
+  // The beam model only depends on the energy: the polynomials are evaluated once per energy
+  // of the plan, and each spot points to the configuration of its energy
+  std::map<double,int> configurationOfEnergy;
+  mSpotConfigurations.clear();
+  mSpotConfigurationIndex.resize(mTotalNumberOfSpots);
+  for (int i = 0; i < mTotalNumberOfSpots; i++) {
+    double energy = mSpotEnergy[i];
+    std::map<double,int>::const_iterator it = configurationOfEnergy.find(energy);
+    if (it != configurationOfEnergy.end()) {
+      mSpotConfigurationIndex[i] = it->second;
+      continue;
+    }
+    SpotConfiguration config;
+    config.energy = GetEnergy(energy);
+    if ( mSigmaEnergyInMeVFlag ){
+      config.sigmaEnergy = GetSigmaEnergy(energy);
+    } else {
+      // sigma energy in percent
+      config.sigmaEnergy = GetSigmaEnergy(energy)*config.energy/100.;
+    }
+    config.sigmaX = GetSigmaX(energy);
+    config.sigmaY = GetSigmaY(energy);
+    config.sigmaTheta = GetSigmaTheta(energy);
+    config.sigmaPhi = GetSigmaPhi(energy);
+    config.ellipseXThetaArea = GetEllipseXThetaArea(energy);
+    config.ellipseYPhiArea = GetEllipseYPhiArea(energy);
+    GateMessage("Beam", 3, "[TPSPencilBeam] configuration " << mSpotConfigurations.size() << ": E=" << energy
+                << " sourceE=" << config.energy << " sigmaE=" << config.sigmaEnergy << " MeV" << Gateendl );
+    configurationOfEnergy[energy] = mSpotConfigurations.size();
+    mSpotConfigurationIndex[i] = mSpotConfigurations.size();
+    mSpotConfigurations.push_back(config);
   }
+  GateMessage("Beam", 1, "[TPSPencilBeam] " << mSpotConfigurations.size() << " beam configurations for " << mTotalNumberOfSpots << " spots." << Gateendl );
+}
+
+//------------------------------------------------------------------------------------------------------
+void GateSourceTPSPencilBeam::ConfigurePencilBeam() {
+  // The pencil beam is only re-initialized if the configuration changes (new energy),
+  // a spot of the same energy only changes the position, rotation and weight
+  const SpotConfiguration & config = mSpotConfigurations[mSpotConfigurationIndex[mCurrentSpot]];
+  GateMessage("Beam", 5, "[TPSPencilBeam] configuring pencil beam with E= " << mSpotEnergy[mCurrentSpot] << Gateendl );
   //Energy
-  GateMessage("Beam", 5, "[TPSPencilBeam] configuring pencil beam with E= " << energy << Gateendl );
-  mPencilBeam->SetEnergy(GetEnergy(energy));
-  if ( mSigmaEnergyInMeVFlag ){
-    GateMessage("Beam", 5, "[TPSPencilBeam] sigma energy from polynomial in MEV" << Gateendl );
-    double sourceE = GetEnergy(energy);
-    mPencilBeam->SetEnergy(sourceE);
-    double sigmaE = GetSigmaEnergy(energy);
-    GateMessage("Beam", 5, "[TPSPencilBeam] : E=" << energy << " sourceE=" << sourceE << " sigmaE=" << sigmaE << Gateendl );
-    mPencilBeam->SetSigmaEnergy(sigmaE);
-  } else {
-    GateMessage("Beam", 5, "[TPSPencilBeam] sigma energy in PERCENT" << Gateendl );
-    double sourceE = GetEnergy(energy);
-    mPencilBeam->SetEnergy(sourceE);
-    double sigmaEPCT = GetSigmaEnergy(energy);
-    double sigmaEMEV = sigmaEPCT*sourceE/100.;
-    GateMessage("Beam", 5, "[TPSPencilBeam] : E=" << energy
-		                   << " sourceE=" << sourceE
-				   << " sigmaEPCT=" << sigmaEPCT
-				   << " sigmaEMEV=" << sigmaEMEV << Gateendl );
-    mPencilBeam->SetSigmaEnergy(sigmaEMEV);
-  }
+  mPencilBeam->SetEnergy(config.energy);
+  mPencilBeam->SetSigmaEnergy(config.sigmaEnergy);
   //Weight
   if (mFlatGenerationFlag) {
     mPencilBeam->SetWeight(mSpotWeight[mCurrentSpot]);
@@ -370,31 +408,32 @@ void GateSourceTPSPencilBeam::ConfigurePencilBeam() {
   }
   //Position
   mPencilBeam->SetPosition(mSpotPosition[mCurrentSpot]);
-  mPencilBeam->SetSigmaX(GetSigmaX(energy));
-  mPencilBeam->SetSigmaY(GetSigmaY(energy));
+  mPencilBeam->SetSigmaX(config.sigmaX);
+  mPencilBeam->SetSigmaY(config.sigmaY);
   //Direction
-  mPencilBeam->SetSigmaTheta(GetSigmaTheta(energy));
-  mPencilBeam->SetEllipseXThetaArea(GetEllipseXThetaArea(energy));
-  mPencilBeam->SetSigmaPhi(GetSigmaPhi(energy));
-  mPencilBeam->SetEllipseYPhiArea(GetEllipseYPhiArea(energy));
+  mPencilBeam->SetSigmaTheta(config.sigmaTheta);
+  mPencilBeam->SetEllipseXThetaArea(config.ellipseXThetaArea);
+  mPencilBeam->SetSigmaPhi(config.sigmaPhi);
+  mPencilBeam->SetEllipseYPhiArea(config.ellipseYPhiArea);
   mPencilBeam->SetRotation(mSpotRotation[mCurrentSpot]);
   //Correlation Position/Direction
   //this parameter is not spot or energy dependent and is therefore once for all at the end of the initialization phase.
 
   mPencilBeam->SetTestFlag(mTestFlag);
   if (mTestFlag) {
+    double energy = mSpotEnergy[mCurrentSpot];
     GateMessage("Beam", 0, "Configuration of spot (ID) No. " << mCurrentSpot << " (out of " << mTotalNumberOfSpots << ")" << Gateendl);
     GateMessage("Beam", 0, "Energy\t" << energy << Gateendl);
     GateMessage("Beam", 0, "Spot metersetweight\t" << mSpotWeight[mCurrentSpot] << Gateendl);
     GateMessage("Beam", 0, "Total Spot metersetweight\t" << mTotalNbIons << Gateendl);
-    GateMessage("Beam", 0, "SetEnergy\t" << GetEnergy(energy) << Gateendl);
+    GateMessage("Beam", 0, "SetEnergy\t" << config.energy << Gateendl);
     GateMessage("Beam", 0, "SetSigmaEnergy\t" << GetSigmaEnergy(energy) << Gateendl);
-    GateMessage("Beam", 0, "SetSigmaX\t" << GetSigmaX(energy) << Gateendl);
-    GateMessage("Beam", 0, "SetSigmaY\t" << GetSigmaY(energy) << Gateendl);
-    GateMessage("Beam", 0, "SetSigmaTheta\t" << GetSigmaTheta(energy) << Gateendl);
-    GateMessage("Beam", 0, "SetSigmaPhi\t" << GetSigmaPhi(energy) << Gateendl);
-    GateMessage("Beam", 0, "SetEllipseXThetaArea\t" << GetEllipseXThetaArea(energy) << Gateendl);
-    GateMessage("Beam", 0, "SetEllipseYPhiArea\t" << GetEllipseYPhiArea(energy) << Gateendl);
+    GateMessage("Beam", 0, "SetSigmaX\t" << config.sigmaX << Gateendl);
+    GateMessage("Beam", 0, "SetSigmaY\t" << config.sigmaY << Gateendl);
+    GateMessage("Beam", 0, "SetSigmaTheta\t" << config.sigmaTheta << Gateendl);
+    GateMessage("Beam", 0, "SetSigmaPhi\t" << config.sigmaPhi << Gateendl);
+    GateMessage("Beam", 0, "SetEllipseXThetaArea\t" << config.ellipseXThetaArea << Gateendl);
+    GateMessage("Beam", 0, "SetEllipseYPhiArea\t" << config.ellipseYPhiArea << Gateendl);
     GateMessage("Beam", 0, "FlatGenerationFlag\t" << (mFlatGenerationFlag?"TRUE":"FALSE") << Gateendl);
     GateMessage("Beam", 0, "ParticleType\t\"" << mParticleType << "\"" << Gateendl);
     GateMessage("Beam", 0, "ParticleParameters\t\"" << mParticleParameters << "\"" << Gateendl);
@@ -71,7 +71,7 @@ void GateSourceVoxelImageReader::ReadFile(G4String filename)
       }
     }
   }
-  PrepareIntegratedActivityMap();
+  PrepareActivityAliasTable();
 }
 //-----------------------------------------------------------------------------
 
@@ -125,7 +125,7 @@ void GateSourceVoxelImageReader::ReadRTFile(G4String , G4String fileName)
 
   inFile.close();
 
-  PrepareIntegratedActivityMap();
+  PrepareActivityAliasTable();
 
 }
 //-----------------------------------------------------------------------------
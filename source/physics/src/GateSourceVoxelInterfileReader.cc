@@ -85,7 +85,7 @@ void GateSourceVoxelInterfileReader::ReadFile(G4String headerFileName)
 	  }
       }
   }
-  PrepareIntegratedActivityMap();
+  PrepareActivityAliasTable();
 }
 
 /* PY Descourt 08/09/2009 */
@@ -143,5 +143,5 @@ void GateSourceVoxelInterfileReader::ReadRTFile(G4String headerFileName, G4Strin
 	  }
       }
   }
-  PrepareIntegratedActivityMap();
+  PrepareActivityAliasTable();
 }
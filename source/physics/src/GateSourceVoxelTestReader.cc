@@ -64,7 +64,7 @@ void GateSourceVoxelTestReader::ReadFile(G4String fileName)
 
   inFile.close();
 
-  PrepareIntegratedActivityMap();
+  PrepareActivityAliasTable();
 
 }
 
@@ -36,7 +36,7 @@ GateVSourceVoxelReader::~GateVSourceVoxelReader()
   if (m_voxelTranslator) {
     delete m_voxelTranslator;
   }
-  m_sourceVoxelIntegratedActivities.clear();
+  m_sourceVoxelAliasTable.Clear();
 }
 //-------------------------------------------------------------------------------------------------
 
@@ -110,9 +110,10 @@ G4int GateVSourceVoxelReader::GetNextSource()
     // if there is at least one voxel
 
     // now assign the event to one voxel, according to the relative activity
-    // integral method
-    // from STL doc: iterator upper_bound(const key_type& k)   Sorted Associative Container   Finds the first element whose key greater than k.
-    firstSource = (m_sourceVoxelIntegratedActivities.upper_bound(G4UniformRand() * m_activityTotal))->second;
+    // (alias method: constant time whatever the number of active voxels)
+    if (m_sourceVoxelAliasTable.IsEmpty())
+      GateError("GateVSourceVoxelReader::GetNextSource : ERROR: No voxel with a positive activity");
+    firstSource = m_sourceVoxelAliasTable.Sample();
 
   }
 
@@ -171,32 +172,26 @@ void GateVSourceVoxelReader::RemoveTranslator()
 
 
 //-------------------------------------------------------------------------------------------------
-void GateVSourceVoxelReader::PrepareIntegratedActivityMap()
+void GateVSourceVoxelReader::PrepareActivityAliasTable()
 {
-  // erase all the elements of the old integrated activity map
-  m_sourceVoxelIntegratedActivities.clear();
-
-  // create the new integrated activity map
-  m_activityTotal = 0.;
-  //GateSourceActivityMap::iterator voxel;
-  for (size_t iVoxel = 0; iVoxel < m_sourceVoxelActivities.size(); iVoxel++) {
-	  if (m_sourceVoxelActivities[iVoxel]>0.0) {
-		  m_activityTotal += m_sourceVoxelActivities[iVoxel];
-		  m_sourceVoxelIntegratedActivities[m_activityTotal] = iVoxel;
-	  }
-  }
+  // build the new alias table (only the voxels with a positive activity get a bin),
+  // it is only rebuilt when the activities change
+  m_sourceVoxelAliasTable.Build(m_sourceVoxelActivities);
+  m_activityTotal = m_sourceVoxelAliasTable.GetTotalWeight();
 
   if (nVerboseLevel>1) {
-	  GateSourceIntegratedActivityMap::iterator intVoxel;
-	  for (intVoxel = m_sourceVoxelIntegratedActivities.begin(); intVoxel != m_sourceVoxelIntegratedActivities.end(); intVoxel++) {
-		  G4int iVoxel = intVoxel->second;
-		  G4cout << "[GateVSourceVoxelReader::PrepareIntegratedActivityMap] "
-				  << "   voxel: " << GetVoxelIndices(iVoxel)
-				  << "   activity : (Bq) " << m_sourceVoxelActivities[iVoxel] / becquerel
-				  << "   integrated: (Bq) " << ((*intVoxel).first)  / becquerel
-				  << Gateendl;
-    }
+	  for (size_t iVoxel = 0; iVoxel < m_sourceVoxelActivities.size(); iVoxel++) {
+		  if (m_sourceVoxelActivities[iVoxel]>0.0)
+			  G4cout << "[GateVSourceVoxelReader::PrepareActivityAliasTable] "
+					  << "   voxel: " << GetVoxelIndices(iVoxel)
+					  << "   activity : (Bq) " << m_sourceVoxelActivities[iVoxel] / becquerel
+					  << Gateendl;
+	  }
   }
+  if (nVerboseLevel>0)
+	  G4cout << "[GateVSourceVoxelReader::PrepareActivityAliasTable] "
+			  << m_sourceVoxelAliasTable.GetNumberOfBins() << " active voxels, total activity (Bq) "
+			  << m_activityTotal / becquerel << Gateendl;
   m_tactivityTotal = m_activityTotal;  // added by I. Martinez-Rovira (immamartinez@gmail.com)
 }
 //-------------------------------------------------------------------------------------------------
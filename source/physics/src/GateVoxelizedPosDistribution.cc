@@ -7,6 +7,7 @@
 
 #include "GateVoxelizedPosDistribution.hh"
 #include "Randomize.hh"
+#include "GateMessageManager.hh"
 
 // trim, tokenize, and get_key_index really belong elsewhere since they're
 // general functions for parsing the header file
@@ -65,7 +66,7 @@ G4String get_path(const G4String str)
 
 GateVoxelizedPosDistribution::GateVoxelizedPosDistribution(G4String filename)
 {
-  G4int i, j, k;
+  G4int i;
 
   G4String data_filename;
   std::ifstream f_in;
@@ -131,63 +132,18 @@ GateVoxelizedPosDistribution::GateVoxelizedPosDistribution(G4String filename)
   // flip y_axis direction
   mResolution[1] = -mResolution[1];
 
-  mPosDistZCDF = new G4double[m_nz];
-  mPosDistYCDF = new G4double*[m_nz];
-  mPosDistXCDF = new G4double**[m_nz];
-  for(i=0;i<m_nz;i++)
-  {
-    mPosDistYCDF[i] = new G4double[m_ny];
-    mPosDistXCDF[i] = new G4double*[m_ny];
-  }
-  for(i=0;i<m_nz;i++)
-    for(j=0;j<m_ny;j++)
-      mPosDistXCDF[i][j] = new G4double[m_nx];
-
-  G4float *temp = new G4float[m_nx];
+  // read the whole distribution in one contiguous array (x fastest), the alias table
+  // keeps one bin per voxel of positive value: empty planes and rows cost nothing
+  std::vector<G4float> data((size_t)m_nx*m_ny*m_nz, 0.f);
 
   f_in.open(data_filename, std::ios::binary);
   if(!f_in.good())
     G4cout << "Error opening data file: " << data_filename << G4endl;
 
-  for(i=0;i<m_nz;i++)
-  {
-    for(j=0;j<m_ny;j++)
-    {
-      f_in.read(reinterpret_cast<char*>(temp),m_nx*sizeof(G4float));
-      mPosDistXCDF[i][j][0] = temp[0];
-      for(k=1;k<m_nx;k++)
-        mPosDistXCDF[i][j][k] = mPosDistXCDF[i][j][k-1] + temp[k];
-
-      // copy sum to y distribution
-      if(j==0)
-        mPosDistYCDF[i][j] = mPosDistXCDF[i][j][m_nx-1];
-      else
-        mPosDistYCDF[i][j] = mPosDistYCDF[i][j-1]+ mPosDistXCDF[i][j][m_nx-1];
-
-      // normalize cumulative x distribution
-      if(mPosDistXCDF[i][j][m_nx-1] != 0.0)
-        for(k=0;k<m_nx;k++)
-          mPosDistXCDF[i][j][k] /= mPosDistXCDF[i][j][m_nx-1];
-
-    }
-    // copy sum to z distribution
-    if (i==0)
-      mPosDistZCDF[i] = mPosDistYCDF[i][m_ny-1];
-    else
-      mPosDistZCDF[i] = mPosDistZCDF[i-1] + mPosDistYCDF[i][m_ny-1];
-
-    // normalize cumulative y distribution
-    if(mPosDistYCDF[i][m_ny-1] != 0.0)
-      for(j=0;j<m_ny;j++)
-        mPosDistYCDF[i][j] /= mPosDistYCDF[i][m_ny-1];
-  }
-  // normalize cumulative z distribution
-  if(mPosDistZCDF[m_nz-1] != 0.0)
-    for(i=0;i<m_nz;i++)
-      mPosDistZCDF[i] /= mPosDistZCDF[m_nz-1];
-
+  f_in.read(reinterpret_cast<char*>(data.data()),data.size()*sizeof(G4float));
   f_in.close();
-  delete [] temp;
+
+  mVoxelTable.Build(data);
 
   mPosition.set(-(m_nx/2)*mResolution[0],-(m_ny/2)*mResolution[1],-(m_nz/2)*mResolution[2]);
 
@@ -200,49 +156,21 @@ GateVoxelizedPosDistribution::GateVoxelizedPosDistribution(G4String filename)
 
 GateVoxelizedPosDistribution::~GateVoxelizedPosDistribution()
 {
-  int i,j;
-
-  for(i=0;i<m_nz;i++)
-  {
-    for(j=0;j<m_ny;j++)
-      if(mPosDistXCDF[i][j])
-        delete [] mPosDistXCDF[i][j];
-
-    if(mPosDistXCDF[i])
-      delete [] mPosDistXCDF[i];
-
-    if(mPosDistYCDF[i])
-      delete [] mPosDistYCDF[i];
-  }
-
-  if(mPosDistXCDF)
-    delete [] mPosDistXCDF;
-  if(mPosDistYCDF)
-    delete [] mPosDistYCDF;
-  if(mPosDistZCDF)
-    delete [] mPosDistZCDF;
 }
 
 G4ThreeVector GateVoxelizedPosDistribution::GenerateOne()
 {
-  G4int i, j, k;
-  G4double p;
+  G4int i, j, k, voxel;
   G4ThreeVector pos;
 
-  i=0;
-  p = G4UniformRand();
-  while(p > mPosDistZCDF[i])
-    i++;
-
-  j=0;
-  p=G4UniformRand();
-  while(p > mPosDistYCDF[i][j])
-    j++;
+  if(mVoxelTable.IsEmpty())
+    GateError("GateVoxelizedPosDistribution::GenerateOne: the voxelized distribution is empty");
 
-  k=0;
-  p=G4UniformRand();
-  while(p > mPosDistXCDF[i][j][k])
-    k++;
+  // one draw for the voxel, then uniform within the voxel
+  voxel = mVoxelTable.Sample();
+  k = voxel % m_nx;
+  j = (voxel / m_nx) % m_ny;
+  i = voxel / (m_nx * m_ny);
 
   pos.set(mResolution[0] * (k + G4UniformRand()),
           mResolution[1] * (j + G4UniformRand()),
@@ -0,0 +1,67 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+/*
+ *	\file GateTestSparseDoseImage.cc
+ *
+ *  The same deposit is scored in a dense and in a sparse GateImageWithStatistic,
+ *  and the dose is computed as in GateDoseActor (edep/density/voxel volume).
+ *  Both doses must be finite and equal.
+ */
+
+#include "GateImageWithStatistic.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+
+#include <cmath>
+#include <iostream>
+
+//-----------------------------------------------------------------------------
+double ComputeDose(bool sparse, int index, double edep, double density)
+{
+  GateImageWithStatistic image;
+  image.EnableSparseImages(sparse);
+  image.EnableUncertaintyImage(true);
+  image.SetResolutionAndHalfSize(G4ThreeVector(50, 40, 30),
+                                 G4ThreeVector(25*mm, 20*mm, 15*mm),
+                                 G4ThreeVector());
+  image.Allocate();
+  image.Reset();
+
+  image.AddTempValue(index, edep);
+  image.EndOfEvent();
+
+  return image.GetValue(index)/density/image.GetVoxelVolume()/gray;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+int main()
+{
+  const int index = 12345;
+  const double edep = 1.5*MeV;
+  const double density = 1.0*g/cm3;
+
+  const double denseDose = ComputeDose(false, index, edep, density);
+  const double sparseDose = ComputeDose(true, index, edep, density);
+
+  std::cout << "dense dose = " << denseDose << " Gy, sparse dose = " << sparseDose << " Gy" << std::endl;
+
+  if (!std::isfinite(denseDose) || !std::isfinite(sparseDose) || denseDose <= 0) {
+    std::cerr << "ERROR: the dose is not finite" << std::endl;
+    return 1;
+  }
+  if (std::fabs(denseDose - sparseDose) > 1e-12*std::fabs(denseDose)) {
+    std::cerr << "ERROR: sparse and dense doses differ" << std::endl;
+    return 1;
+  }
+  return 0;
+}
+//-----------------------------------------------------------------------------